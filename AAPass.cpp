@@ -1,8 +1,13 @@
+#include <MemoryModel/PAG.h>
 #include <MemoryModel/PointerAnalysis.h>
 #include <WPA/Andersen.h>
 #include <WPA/FlowSensitive.h>
 
 #include "AAPass.h"
+#include "DemandAndersen.h"
+#include "StagedAndersen.h"
+#include "SelectiveFlowSensitive.h"
+#include "ParallelAndersen.h"
 
 using namespace llvm;
 
@@ -15,12 +20,66 @@ AAPass::~AAPass() {
     delete _pta;
 }
 
+void AAPass::releasePTA() {
+    delete _pta;
+    _pta = NULL;
+    PAG::releasePAG();
+    aliasCache.clear();
+    isReleased = true;
+}
+
 bool AAPass::runOnModule(llvm::Module& module) {
+    /* the cached results belong to the previous analysis */
+    aliasCache.clear();
     runPointerAnalysis(module, type);
     return false;
 }
 
 void AAPass::runPointerAnalysis(llvm::Module& module, u32_t kind) {
+    /* the solvers can't be combined, so don't pick one of them silently */
+    unsigned int modes = refineMode + stagedMode + demandMode + parallelMode;
+    if (modes > 1) {
+        llvm::errs() << "AAPass: the refine, staged, demand and parallel modes are exclusive\n";
+        assert(false);
+    }
+    if (benchmarkMode && !parallelMode) {
+        llvm::errs() << "AAPass: the benchmark mode requires the parallel mode\n";
+        assert(false);
+    }
+
+    if (refineMode) {
+        /* the other pointers get the Andersen results */
+        _pta = new SelectiveFlowSensitive(demandedValues);
+        _pta->analyze(module);
+        return;
+    }
+
+    if (stagedMode) {
+        /* the other pointers get the Steensgaard results */
+        _pta = new StagedAndersen(demandedValues);
+        _pta->analyze(module);
+        return;
+    }
+
+    if (demandMode) {
+        /* only Andersen is supported in demand-driven mode */
+        _pta = new DemandAndersen(demandedValues);
+        _pta->analyze(module);
+        return;
+    }
+
+    if (parallelMode) {
+        ParallelAndersen *parallel = new ParallelAndersen(threads);
+        _pta = parallel;
+        if (benchmarkMode) {
+            /* analyzes the solver which is kept */
+            ParallelAndersen::benchmark(module, parallel, *debugs);
+        } else {
+            _pta->analyze(module);
+        }
+        return;
+    }
+
     switch (kind) {
     case PointerAnalysis::Andersen_WPA:
         _pta = new Andersen();
@@ -46,12 +105,94 @@ void AAPass::runPointerAnalysis(llvm::Module& module, u32_t kind) {
 }
 
 llvm::AliasAnalysis::AliasResult AAPass::alias(const Value* V1, const Value* V2) {
+    assert(!isReleased);
+
     llvm::AliasAnalysis::AliasResult result = MayAlias;
 
     PAG* pag = _pta->getPAG();
-    if (pag->hasValueNode(V1) && pag->hasValueNode(V2)) {
-        result = _pta->alias(V1, V2);
+    if (!pag->hasValueNode(V1) || !pag->hasValueNode(V2)) {
+        /* e.g. values which were created after the analysis */
+        return result;
     }
 
+    NodePair key = getKey(pag->getValueNode(V1), pag->getValueNode(V2));
+    if (lookupAlias(key, result)) {
+        return result;
+    }
+
+    result = _pta->alias(V1, V2);
+
+    aliasCache[key] = result;
     return result;
 }
+
+void AAPass::alias(const ValuePairs &pairs, AliasResults &results) {
+    assert(!isReleased);
+
+    /* the nodes of the values in this batch (the points-to sets may be moved by getPts) */
+    std::map<const Value *, NodeID> nodesMap;
+    std::set<const Value *> missing;
+    PAG* pag = _pta->getPAG();
+
+    results.clear();
+    results.reserve(pairs.size());
+
+    for (ValuePairs::const_iterator i = pairs.begin(); i != pairs.end(); i++) {
+        llvm::AliasAnalysis::AliasResult result = MayAlias;
+
+        NodeID nodes[2];
+        bool found = true;
+        const Value *values[2] = {i->first, i->second};
+        for (unsigned int j = 0; j < 2; j++) {
+            std::map<const Value *, NodeID>::iterator entry = nodesMap.find(values[j]);
+            if (entry != nodesMap.end()) {
+                nodes[j] = entry->second;
+                continue;
+            }
+
+            if (missing.find(values[j]) != missing.end() || !pag->hasValueNode(values[j])) {
+                missing.insert(values[j]);
+                found = false;
+                continue;
+            }
+
+            nodes[j] = pag->getValueNode(values[j]);
+            nodesMap[values[j]] = nodes[j];
+        }
+
+        if (!found) {
+            results.push_back(result);
+            continue;
+        }
+
+        NodePair key = getKey(nodes[0], nodes[1]);
+        if (!lookupAlias(key, result)) {
+            /* copied, since the second lookup may invalidate the first reference */
+            PointsTo pts = _pta->getPts(nodes[0]);
+            result = _pta->alias(pts, _pta->getPts(nodes[1]));
+            aliasCache[key] = result;
+        }
+
+        results.push_back(result);
+    }
+}
+
+AAPass::NodePair AAPass::getKey(NodeID n1, NodeID n2) {
+    if (n2 < n1) {
+        return std::make_pair(n2, n1);
+    }
+
+    return std::make_pair(n1, n2);
+}
+
+bool AAPass::lookupAlias(const NodePair &key, llvm::AliasAnalysis::AliasResult &result) {
+    AliasCache::iterator entry = aliasCache.find(key);
+    if (entry == aliasCache.end()) {
+        cacheMisses++;
+        return false;
+    }
+
+    cacheHits++;
+    result = entry->second;
+    return true;
+}
@@ -1,9 +1,15 @@
 #ifndef AAPASS_H
 #define AAPASS_H
 
+#include <assert.h>
+#include <map>
+#include <set>
+#include <vector>
+
 #include "MemoryModel/PointerAnalysis.h"
 #include <llvm/Analysis/AliasAnalysis.h>
 #include <llvm/Pass.h>
+#include <llvm/Support/raw_ostream.h>
 
 class AAPass: public llvm::ModulePass, public llvm::AliasAnalysis {
 
@@ -16,7 +22,12 @@ public:
         Precise            ///< return alias result by the most precise pta
     };
 
-    AAPass() : llvm::ModulePass(ID), llvm::AliasAnalysis(), type(PointerAnalysis::Default_PTA), _pta(0) {}
+    typedef std::pair<const llvm::Value *, const llvm::Value *> ValuePair;
+    typedef std::vector<ValuePair> ValuePairs;
+    typedef std::vector<llvm::AliasAnalysis::AliasResult> AliasResults;
+    typedef std::set<const llvm::Value *> ValueSet;
+
+    AAPass() : llvm::ModulePass(ID), llvm::AliasAnalysis(), type(PointerAnalysis::Default_PTA), _pta(0), demandMode(false), stagedMode(false), refineMode(false), parallelMode(false), benchmarkMode(false), debugs(&llvm::nulls()), threads(0), cacheHits(0), cacheMisses(0), isReleased(false) {}
 
     ~AAPass();
 
@@ -34,6 +45,9 @@ public:
 
     virtual llvm::AliasAnalysis::AliasResult alias(const llvm::Value* V1,    const llvm::Value* V2);
 
+    /* answer a batch of queries (the points-to set of each value is fetched once) */
+    void alias(const ValuePairs &pairs, AliasResults &results);
+
     virtual bool runOnModule(llvm::Module& module);
 
     virtual inline const char* getPassName() const {
@@ -44,15 +58,82 @@ public:
         this->type = type;
     }
 
+    /* run a Steensgaard pre-pass, and solve with Andersen only the classes which affect the given values */
+    void setStagedValues(const ValueSet &values) {
+        demandedValues = values;
+        stagedMode = true;
+    }
+
+    /* run Andersen, and refine flow-sensitively only the pointers which affect the given values */
+    void setRefinedValues(const ValueSet &values) {
+        demandedValues = values;
+        refineMode = true;
+    }
+
+    /* use the multi-threaded wave propagation solver (0 threads means one per core) */
+    void setParallel(unsigned int threads) {
+        this->threads = threads;
+        parallelMode = true;
+    }
+
+    /* compare the parallel solver with the serial one (reported to the debug stream) */
+    void setBenchmarkMode(bool enabled, llvm::raw_ostream &debugs) {
+        benchmarkMode = enabled;
+        this->debugs = &debugs;
+    }
+
+    /* solve only for the given values (the other queries get the Steensgaard results) */
+    void setDemandedValues(const ValueSet &values) {
+        demandedValues = values;
+        demandMode = true;
+    }
+
     BVDataPTAImpl *getPTA() {
+        assert(!isReleased);
         return _pta;
     }
 
+    uint64_t getCacheHits() {
+        return cacheHits;
+    }
+
+    uint64_t getCacheMisses() {
+        return cacheMisses;
+    }
+
+    void clearAliasCache() {
+        aliasCache.clear();
+    }
+
+    /* free the solver and the PAG, once no more queries are made (no query may follow) */
+    void releasePTA();
+
 private:
+    typedef std::pair<NodeID, NodeID> NodePair;
+    /* keyed by the nodes (values may be erased, and their addresses reused, after the analysis),
+       the queries are symmetric, so each pair is cached once */
+    typedef std::map<NodePair, llvm::AliasAnalysis::AliasResult> AliasCache;
+
     void runPointerAnalysis(llvm::Module& module, u32_t kind);
 
+    static NodePair getKey(NodeID n1, NodeID n2);
+
+    bool lookupAlias(const NodePair &key, llvm::AliasAnalysis::AliasResult &result);
+
     PointerAnalysis::PTATY type;
     BVDataPTAImpl* _pta;
+    bool demandMode;
+    ValueSet demandedValues;
+    bool stagedMode;
+    bool refineMode;
+    bool parallelMode;
+    bool benchmarkMode;
+    llvm::raw_ostream *debugs;
+    unsigned int threads;
+    AliasCache aliasCache;
+    uint64_t cacheHits;
+    uint64_t cacheMisses;
+    bool isReleased;
 };
 
 #endif /* AAPASS_H */
@@ -14,6 +14,7 @@
 
 #include "ModRefAnalysis.h"
 #include "Annotator.h"
+#include "LibrarySummaries.h"
 
 using namespace std;
 using namespace llvm;
@@ -24,15 +25,32 @@ void Annotator::annotate() {
 
     for (ModRefAnalysis::ModInfoToStoreMap::iterator i = modInfoToStoreMap.begin(); i != modInfoToStoreMap.end(); i++) {
         ModRefAnalysis::ModInfo modInfo = i->first;
-        set<Instruction *> &stores = i->second;
+        const set<Instruction *> &stores = *i->second;
 
         uint32_t sliceId = modInfoToIdMap[modInfo];
         annotateStores(stores, sliceId);
     }
+
+    /* call-site mode */
+    ModRefAnalysis::CallSiteModInfoToStoreMap &callSiteModInfoToStoreMap = mra->getCallSiteModInfoToStoreMap();
+    ModRefAnalysis::CallSiteModInfoToIdMap &callSiteModInfoToIdMap = mra->getCallSiteModInfoToIdMap();
+
+    for (ModRefAnalysis::CallSiteModInfoToStoreMap::iterator i = callSiteModInfoToStoreMap.begin(); i != callSiteModInfoToStoreMap.end(); i++) {
+        ModRefAnalysis::CallSiteModInfo callSiteModInfo = i->first;
+        const set<Instruction *> &stores = *i->second;
+
+        uint32_t sliceId = callSiteModInfoToIdMap[callSiteModInfo];
+        annotateStores(stores, sliceId);
+    }
 }
 
-void Annotator::annotateStores(set<Instruction *> &stores, uint32_t sliceId) {
-    for (set<Instruction *>::iterator i = stores.begin(); i != stores.end(); i++) {
+void Annotator::annotateStores(const set<Instruction *> &stores, uint32_t sliceId) {
+    sliceStoresMap[sliceId].insert(stores.begin(), stores.end());
+    if (!instrumentMode) {
+        return;
+    }
+
+    for (set<Instruction *>::const_iterator i = stores.begin(); i != stores.end(); i++) {
         Instruction *inst = *i;
         annotateStore(inst, sliceId);
     }
@@ -40,13 +58,25 @@ void Annotator::annotateStores(set<Instruction *> &stores, uint32_t sliceId) {
 
 void Annotator::annotateStore(Instruction *inst, uint32_t sliceId) {
     StoreInst *store = dyn_cast<StoreInst>(inst);
-    Value *pointerOperand = store->getPointerOperand();
+    if (store) {
+        annotatePointer(inst, store->getPointerOperand(), store->getAlignment(), sliceId);
+        return;
+    }
+
+    /* a summarized call (memcpy, etc.) */
+    vector<Value *> pointers;
+    LibrarySummaries::getModifiedPointers(inst, pointers);
+    for (vector<Value *>::iterator i = pointers.begin(); i != pointers.end(); i++) {
+        annotatePointer(inst, *i, 1, sliceId);
+    }
+}
 
+void Annotator::annotatePointer(Instruction *inst, Value *pointerOperand, unsigned alignment, uint32_t sliceId) {
     /* generate a unique argument name */
     string name = string("__crit_arg_") + to_string(argId++);
     /* insert load */
     LoadInst *loadInst = new LoadInst(pointerOperand, name.data());
-    loadInst->setAlignment(store->getAlignment());
+    loadInst->setAlignment(alignment);
     loadInst->insertAfter(inst);
 
     /* create criterion function */
@@ -57,6 +87,33 @@ void Annotator::annotateStore(Instruction *inst, uint32_t sliceId) {
     args.push_back(dyn_cast<Value>(loadInst));
     CallInst *callInst = CallInst::Create(criterionFunction, args, "");
     callInst->insertAfter(loadInst);
+
+    annotations.push_back(loadInst);
+    annotations.push_back(callInst);
+}
+
+void Annotator::removeAnnotations() {
+    /* the users first */
+    for (vector<Instruction *>::reverse_iterator i = annotations.rbegin(); i != annotations.rend(); i++) {
+        (*i)->eraseFromParent();
+    }
+
+    annotations.clear();
+
+    /* the criterion functions which are not called by any slice */
+    for (AnnotationsMap::iterator i = annotationsMap.begin(); i != annotationsMap.end(); i++) {
+        set<string> &fnames = i->second.fnames;
+        set<string>::iterator j = fnames.begin();
+        while (j != fnames.end()) {
+            Function *f = module->getFunction(*j);
+            if (f && f->use_empty()) {
+                f->eraseFromParent();
+                fnames.erase(j++);
+            } else {
+                j++;
+            }
+        }
+    }
 }
 
 Function *Annotator::getCriterionFunction(Value *pointerOperand, uint32_t sliceId) {
@@ -107,3 +164,13 @@ set<string> &Annotator::getAnnotatedNames(uint32_t sliceId) {
 
     return i->second.fnames;
 }
+
+set<Instruction *> &Annotator::getStores(uint32_t sliceId) {
+    SliceStoresMap::iterator i = sliceStoresMap.find(sliceId);
+    if (i == sliceStoresMap.end()) {
+        /* TODO: this should not happen */
+        assert(false);
+    }
+
+    return i->second;
+}
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <map>
 #include <set>
+#include <vector>
 
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
@@ -25,23 +26,42 @@ public:
         }
     };
     typedef std::map<uint32_t, AnnotationInfo> AnnotationsMap;
+    typedef std::map<uint32_t, std::set<llvm::Instruction *> > SliceStoresMap;
 
     Annotator(llvm::Module *module, ModRefAnalysis *mra) :
-        module(module), mra(mra), argId(0)
+        module(module), mra(mra), argId(0), instrumentMode(true)
     {
 
     }
 
+    /* insert the criterion calls (otherwise, only the stores of each slice are collected) */
+    void setInstrumentMode(bool enabled) {
+        instrumentMode = enabled;
+    }
+
     void annotate();
 
+    /* the modifying stores of the slice, which can be used directly as criteria */
+    std::set<llvm::Instruction *> &getStores(uint32_t sliceId);
+
+    /* the inserted instructions */
+    std::vector<llvm::Instruction *> &getAnnotations() {
+        return annotations;
+    }
+
+    /* remove the inserted instructions and the unused criterion functions (the clones keep their copies) */
+    void removeAnnotations();
+
     std::set<std::string> &getAnnotatedNames(uint32_t sliceId);
 
 private:
 
-    void annotateStores(std::set<llvm::Instruction *> &stores, uint32_t sliceId);
+    void annotateStores(const std::set<llvm::Instruction *> &stores, uint32_t sliceId);
 
     void annotateStore(llvm::Instruction *inst, uint32_t sliceId);
 
+    void annotatePointer(llvm::Instruction *inst, llvm::Value *pointerOperand, unsigned alignment, uint32_t sliceId);
+
     static std::string getAnnotatedName(uint32_t sliceId, uint32_t subId);
 
     llvm::Function *getCriterionFunction(llvm::Value *pointer, uint32_t sliceId);
@@ -50,6 +70,10 @@ private:
     ModRefAnalysis *mra;
     AnnotationsMap annotationsMap;
     uint32_t argId;
+    /* the inserted instructions, in insertion order */
+    std::vector<llvm::Instruction *> annotations;
+    bool instrumentMode;
+    SliceStoresMap sliceStoresMap;
 };
 
 #endif
@@ -133,6 +133,20 @@ Value *Cloner::translateValue(Value *value) {
     return i->second;
 }
 
+void Cloner::removeTranslations(const set<Value *> &values) {
+    for (CloneInfoMap::iterator i = cloneInfoMap.begin(); i != cloneInfoMap.end(); i++) {
+        ValueTranslationMap *map = i->second;
+        ValueTranslationMap::iterator j = map->begin();
+        while (j != map->end()) {
+            if (values.find(j->second) != values.end()) {
+                map->erase(j++);
+            } else {
+                j++;
+            }
+        }
+    }
+}
+
 Cloner::~Cloner() {
     for (FunctionMap::iterator i = functionMap.begin(); i != functionMap.end(); i++) {
         SliceMap &sliceMap = i->second;
@@ -43,6 +43,9 @@ public:
 
     llvm::Value *translateValue(llvm::Value *);
 
+    /* drop the translations to original values which are about to be erased */
+    void removeTranslations(const std::set<llvm::Value *> &values);
+
 private:
 
     void cloneFunction(llvm::Function *f, uint32_t sliceId);
@@ -0,0 +1,178 @@
+#include <stdbool.h>
+#include <vector>
+#include <map>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Value.h>
+#include <llvm/Support/CallSite.h>
+
+#include <MemoryModel/PAG.h>
+#include <MemoryModel/PointerAnalysis.h>
+#include <WPA/Andersen.h>
+
+#include "DemandAndersen.h"
+
+using namespace std;
+using namespace llvm;
+
+DemandAndersen::~DemandAndersen() {
+    delete steensgaard;
+}
+
+void DemandAndersen::analyze(Module &module) {
+    Andersen::analyze(module);
+    /* from now on, the irrelevant nodes are handled by the fallback */
+    isSolved = true;
+}
+
+void DemandAndersen::initialize(Module &module) {
+    Andersen::initialize(module);
+
+    this->module = &module;
+
+    steensgaard = new Steensgaard(getPAG(), &module);
+    steensgaard->run();
+
+    computeRelevantNodes();
+}
+
+PointsTo &DemandAndersen::getPts(NodeID id) {
+    if (!isSolved || isRelevant(id)) {
+        return Andersen::getPts(id);
+    }
+
+    fallbackQueries++;
+    return getFallbackPts(id);
+}
+
+PointsTo &DemandAndersen::getFallbackPts(NodeID id) {
+    return steensgaard->getPts(id);
+}
+
+bool DemandAndersen::isRelevant(NodeID id) {
+    if (relevant.test(id)) {
+        return true;
+    }
+
+    /* the field objects which are created while solving are relevant as their base object */
+    PAG *pag = getPAG();
+    if (isa<GepObjPN>(pag->getPAGNode(id)) && relevant.test(pag->getBaseObjNode(id))) {
+        relevant.set(id);
+        return true;
+    }
+
+    /* the node may be merged (cycle elimination) with a relevant node */
+    NodeID rep = sccRepNode(id);
+    return relevant.test(rep) || relevant.intersects(consCG->sccSubNodes(rep));
+}
+
+void DemandAndersen::processNode(NodeID nodeId) {
+    if (!isRelevant(nodeId)) {
+        /* the node does not flow into any query */
+        skippedNodes++;
+        return;
+    }
+
+    Andersen::processNode(nodeId);
+}
+
+void DemandAndersen::computeRelevantNodes() {
+    PAG *pag = getPAG();
+    vector<NodeID> worklist;
+
+    /* the stores by the class of the objects they may modify */
+    map<NodeID, vector<PAGEdge *> > classStores;
+    PAGEdge::PAGEdgeSetTy &stores = pag->getEdgeSet(PAGEdge::Store);
+    for (PAGEdge::PAGEdgeSetTy::iterator i = stores.begin(); i != stores.end(); ++i) {
+        PAGEdge *edge = *i;
+        if (steensgaard->hasPointee(edge->getDstID())) {
+            classStores[steensgaard->getPointeeClass(edge->getDstID())].push_back(edge);
+        }
+    }
+
+    /* the contents of the objects are propagated through the object nodes */
+    for (PAG::iterator i = pag->begin(); i != pag->end(); ++i) {
+        if (isa<ObjPN>(i->second)) {
+            relevant.set(i->first);
+        }
+    }
+
+    for (ValueSet::iterator i = queries.begin(); i != queries.end(); i++) {
+        addRelevant(*i, worklist);
+    }
+
+    /* the edges of the indirect calls are added during the analysis */
+    const PAG::CallSiteToFunPtrMap &indirectCalls = pag->getIndirectCallsites();
+    for (PAG::CallSiteToFunPtrMap::const_iterator i = indirectCalls.begin(); i != indirectCalls.end(); ++i) {
+        CallSite cs = i->first;
+        addRelevant(i->second, worklist);
+        for (CallSite::arg_iterator j = cs.arg_begin(); j != cs.arg_end(); ++j) {
+            addRelevant(j->get(), worklist);
+        }
+    }
+
+    for (Module::iterator i = module->begin(); i != module->end(); i++) {
+        Function *f = &*i;
+        if (f->hasAddressTaken() && pag->funHasRet(f)) {
+            addRelevant(pag->getReturnNode(f), worklist);
+        }
+    }
+
+    while (!worklist.empty()) {
+        NodeID id = worklist.back();
+        worklist.pop_back();
+
+        PAGNode *node = pag->getPAGNode(id);
+        for (PAGNode::const_iterator i = node->InEdgeBegin(); i != node->InEdgeEnd(); ++i) {
+            PAGEdge *edge = *i;
+
+            switch (edge->getEdgeKind()) {
+            case PAGEdge::Addr:
+            case PAGEdge::Store:
+                /* doesn't affect the points-to set of the destination */
+                break;
+
+            case PAGEdge::Load:
+                addRelevant(edge->getSrcID(), worklist);
+                if (steensgaard->hasPointee(edge->getSrcID())) {
+                    /* the loaded objects may be modified only by the stores to their class */
+                    map<NodeID, vector<PAGEdge *> >::iterator entry = classStores.find(steensgaard->getPointeeClass(edge->getSrcID()));
+                    if (entry != classStores.end()) {
+                        vector<PAGEdge *> &edges = entry->second;
+                        for (vector<PAGEdge *>::iterator j = edges.begin(); j != edges.end(); j++) {
+                            addRelevant((*j)->getSrcID(), worklist);
+                            addRelevant((*j)->getDstID(), worklist);
+                        }
+                        /* added once per class */
+                        classStores.erase(entry);
+                    }
+                }
+                break;
+
+            default:
+                /* copy, gep, call, return, etc. */
+                addRelevant(edge->getSrcID(), worklist);
+                break;
+            }
+        }
+    }
+}
+
+void DemandAndersen::addRelevant(NodeID id, vector<NodeID> &worklist) {
+    if (relevant.test(id)) {
+        return;
+    }
+
+    relevant.set(id);
+    worklist.push_back(id);
+}
+
+void DemandAndersen::addRelevant(const Value *value, vector<NodeID> &worklist) {
+    PAG *pag = getPAG();
+    if (!pag->hasValueNode(value)) {
+        return;
+    }
+
+    addRelevant(pag->getValueNode(value), worklist);
+}
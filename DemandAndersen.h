@@ -0,0 +1,87 @@
+#ifndef DEMANDANDERSEN_H
+#define DEMANDANDERSEN_H
+
+#include <stdbool.h>
+#include <set>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Value.h>
+
+#include <MemoryModel/PointerAnalysis.h>
+#include <WPA/Andersen.h>
+
+#include "Steensgaard.h"
+
+/*
+ * An Andersen analysis which propagates points-to information only through
+ * the nodes which may affect the queried values. The relevant nodes are the
+ * backward closure of the queries in the PAG (the objects are always relevant).
+ * Queries about other nodes are answered by a Steensgaard pre-pass, which
+ * also tells which stores may affect a relevant load.
+ */
+class DemandAndersen : public Andersen {
+public:
+
+    typedef std::set<const llvm::Value *> ValueSet;
+
+    DemandAndersen(const ValueSet &queries) :
+        Andersen(),
+        queries(queries),
+        module(NULL),
+        steensgaard(NULL),
+        isSolved(false),
+        skippedNodes(0),
+        fallbackQueries(0)
+    {
+
+    }
+
+    virtual ~DemandAndersen();
+
+    virtual void analyze(llvm::Module &module);
+
+    virtual void initialize(llvm::Module &module);
+
+    virtual PointsTo &getPts(NodeID id);
+
+    bool isRelevant(NodeID id);
+
+    uint32_t getRelevantCount() {
+        return relevant.count();
+    }
+
+    uint64_t getSkippedNodes() {
+        return skippedNodes;
+    }
+
+    uint64_t getFallbackQueries() {
+        return fallbackQueries;
+    }
+
+protected:
+
+    virtual void processNode(NodeID nodeId);
+
+    /* called after the PAG and the constraint graph are built */
+    virtual void computeRelevantNodes();
+
+    /* the answer for a node which is not relevant */
+    PointsTo &getFallbackPts(NodeID id);
+
+    void addRelevant(NodeID id, std::vector<NodeID> &worklist);
+
+    void addRelevant(const llvm::Value *value, std::vector<NodeID> &worklist);
+
+    ValueSet queries;
+    llvm::Module *module;
+    NodeBS relevant;
+    Steensgaard *steensgaard;
+
+private:
+
+    bool isSolved;
+    uint64_t skippedNodes;
+    uint64_t fallbackQueries;
+};
+
+#endif /* DEMANDANDERSEN_H */
@@ -0,0 +1,140 @@
+#include <stdbool.h>
+#include <assert.h>
+#include <stack>
+#include <set>
+#include <map>
+
+#include <llvm/IR/Value.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+
+#include "EscapeAnalysis.h"
+
+using namespace std;
+using namespace llvm;
+
+EscapeAnalysis::EscapeKind EscapeAnalysis::getEscapeKind(AllocaInst *alloca) {
+    EscapeCache::iterator i = cache.find(alloca);
+    if (i != cache.end()) {
+        return i->second;
+    }
+
+    FunctionSet callees;
+    EscapeKind kind = computeEscapeKind(alloca, callees);
+    cache.insert(make_pair(alloca, kind));
+    if (kind == DownwardEscape) {
+        calleesMap[alloca] = callees;
+    }
+    return kind;
+}
+
+EscapeAnalysis::FunctionSet &EscapeAnalysis::getCallees(AllocaInst *alloca) {
+    assert(getEscapeKind(alloca) == DownwardEscape);
+    return calleesMap[alloca];
+}
+
+EscapeAnalysis::EscapeKind EscapeAnalysis::computeEscapeKind(AllocaInst *alloca, FunctionSet &callees) {
+    stack<Value *> stack;
+    set<Value *> visited;
+    EscapeKind result = NoEscape;
+
+    /* the alloca and the pointers derived from it */
+    stack.push(alloca);
+    visited.insert(alloca);
+
+    while (!stack.empty()) {
+        Value *value = stack.top();
+        stack.pop();
+
+        for (Value::use_iterator i = value->use_begin(); i != value->use_end(); i++) {
+            User *user = *i;
+
+            bool isDerived = false;
+            EscapeKind kind = getUseKind(value, user, isDerived, callees);
+            if (kind == GlobalEscape) {
+                /* no need to continue */
+                return GlobalEscape;
+            }
+            if (kind == DownwardEscape) {
+                result = DownwardEscape;
+            }
+
+            if (isDerived && visited.find(user) == visited.end()) {
+                stack.push(user);
+                visited.insert(user);
+            }
+        }
+    }
+
+    return result;
+}
+
+EscapeAnalysis::EscapeKind EscapeAnalysis::getUseKind(Value *value, User *user, bool &isDerived, FunctionSet &callees) {
+    if (isa<LoadInst>(user)) {
+        return NoEscape;
+    }
+
+    if (isa<StoreInst>(user)) {
+        StoreInst *store = dyn_cast<StoreInst>(user);
+        if (store->getValueOperand() == value) {
+            /* the address itself is written to memory */
+            return GlobalEscape;
+        }
+        return NoEscape;
+    }
+
+    if (isa<GetElementPtrInst>(user) || isa<BitCastInst>(user) || isa<PHINode>(user) || isa<SelectInst>(user)) {
+        isDerived = true;
+        return NoEscape;
+    }
+
+    if (isa<ICmpInst>(user)) {
+        return NoEscape;
+    }
+
+    if (isa<CallInst>(user)) {
+        CallInst *callInst = dyn_cast<CallInst>(user);
+        if (callInst->getCalledValue() == value) {
+            return GlobalEscape;
+        }
+
+        /* these intrinsics access the contents, but don't capture the address */
+        if (isa<MemIntrinsic>(callInst)) {
+            return NoEscape;
+        }
+
+        IntrinsicInst *intrinsic = dyn_cast<IntrinsicInst>(callInst);
+        if (intrinsic) {
+            switch (intrinsic->getIntrinsicID()) {
+            case Intrinsic::lifetime_start:
+            case Intrinsic::lifetime_end:
+                return NoEscape;
+
+            default:
+                break;
+            }
+        }
+
+        /* the callee may capture the address (e.g. in a global), so it may be
+           accessed even by functions which are not called with it */
+        Function *callee = callInst->getCalledFunction();
+        if (!callee) {
+            return GlobalEscape;
+        }
+
+        for (unsigned int i = 0; i < callInst->getNumArgOperands(); i++) {
+            if (callInst->getArgOperand(i) == value && !callInst->doesNotCapture(i)) {
+                return GlobalEscape;
+            }
+        }
+
+        /* accessed only during the call */
+        callees.insert(callee);
+        return DownwardEscape;
+    }
+
+    /* returned, converted to an integer, etc. */
+    return GlobalEscape;
+}
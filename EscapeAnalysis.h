@@ -0,0 +1,49 @@
+#ifndef ESCAPEANALYSIS_H
+#define ESCAPEANALYSIS_H
+
+#include <stdbool.h>
+#include <set>
+#include <map>
+
+#include <llvm/IR/Instructions.h>
+
+/* classifies stack objects by the way their address may leave the allocating function */
+class EscapeAnalysis {
+public:
+
+    typedef enum {
+        /* only the allocating function accesses the object */
+        NoEscape,
+        /* the address is passed only to callees which don't capture it (nocapture) */
+        DownwardEscape,
+        /* the address may be captured by a callee, stored, returned, etc. */
+        GlobalEscape,
+    } EscapeKind;
+
+    EscapeAnalysis() {
+
+    }
+
+    ~EscapeAnalysis() {};
+
+    typedef std::set<llvm::Function *> FunctionSet;
+
+    EscapeKind getEscapeKind(llvm::AllocaInst *alloca);
+
+    /* the callees which get the address of a downward escaping object */
+    FunctionSet &getCallees(llvm::AllocaInst *alloca);
+
+private:
+
+    typedef std::map<llvm::AllocaInst *, EscapeKind> EscapeCache;
+    typedef std::map<llvm::AllocaInst *, FunctionSet> CalleesMap;
+
+    EscapeKind computeEscapeKind(llvm::AllocaInst *alloca, FunctionSet &callees);
+
+    EscapeKind getUseKind(llvm::Value *value, llvm::User *user, bool &isDerived, FunctionSet &callees);
+
+    EscapeCache cache;
+    CalleesMap calleesMap;
+};
+
+#endif /* ESCAPEANALYSIS_H */
@@ -0,0 +1,318 @@
+#include <stdio.h>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <stack>
+#include <set>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/Support/InstIterator.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+#include "HeapCloner.h"
+
+using namespace std;
+using namespace llvm;
+
+void HeapCloner::resolveFunctions() {
+    if (isResolved) {
+        return;
+    }
+
+    for (vector<string>::iterator i = targetNames.begin(); i != targetNames.end(); i++) {
+        Function *f = module->getFunction(*i);
+        if (!f) {
+            errs() << "WARNING: function '" << *i << "' is not found\n";
+            continue;
+        }
+        targets.insert(f);
+    }
+
+    isResolved = true;
+}
+
+void HeapCloner::run() {
+    resolveFunctions();
+
+    findWrappers();
+    if (wrappers.empty()) {
+        return;
+    }
+
+    /* the clones of an outer wrapper add call sites to the inner wrappers, so use fixpoint */
+    bool changed;
+    do {
+        changed = false;
+
+        /* cloneCallSites() adds new wrappers, so iterate over a copy */
+        FunctionSet current = wrappers;
+        for (FunctionSet::iterator i = current.begin(); i != current.end(); i++) {
+            if (cloneCallSites(*i)) {
+                changed = true;
+            }
+        }
+    } while (changed);
+}
+
+void HeapCloner::findWrappers() {
+    bool changed;
+
+    /* a wrapper may call another wrapper, so use fixpoint */
+    do {
+        changed = false;
+        for (Module::iterator i = module->begin(); i != module->end(); i++) {
+            Function *f = &*i;
+            if (f->isDeclaration() || wrappers.find(f) != wrappers.end()) {
+                continue;
+            }
+
+            /* the call sites of the targets must not be changed */
+            if (targets.find(f) != targets.end()) {
+                continue;
+            }
+
+            if (isWrapper(f)) {
+                debugs << "allocation wrapper: " << f->getName() << "\n";
+                wrappers.insert(f);
+                changed = true;
+            }
+        }
+    } while (changed);
+}
+
+bool HeapCloner::isAllocator(Function *f) {
+    const char *allocators[] = {
+        "malloc",
+        "calloc",
+        "realloc",
+        "valloc",
+        "memalign",
+        "strdup",
+        "strndup",
+        "_Znwm",
+        "_Znam",
+        NULL
+    };
+
+    if (wrappers.find(f) != wrappers.end()) {
+        return true;
+    }
+
+    if (!f->isDeclaration()) {
+        return false;
+    }
+
+    for (unsigned int i = 0; allocators[i]; i++) {
+        if (f->getName().equals(allocators[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* a small function which returns the allocated object, or stores it through an argument */
+bool HeapCloner::isWrapper(Function *f) {
+    bool allocates = false;
+
+    uint32_t size = 0;
+    for (inst_iterator i = inst_begin(f); i != inst_end(f); i++) {
+        size++;
+    }
+    if (size > maxSize) {
+        return false;
+    }
+
+    for (inst_iterator i = inst_begin(f); i != inst_end(f); i++) {
+        Instruction *inst = &*i;
+        CallInst *callInst = dyn_cast<CallInst>(inst);
+        if (!callInst) {
+            continue;
+        }
+
+        Function *calledFunction = callInst->getCalledFunction();
+        if (!calledFunction) {
+            continue;
+        }
+
+        if (calledFunction == f) {
+            /* recursive functions are not cloned */
+            return false;
+        }
+
+        if (!isAllocator(calledFunction)) {
+            continue;
+        }
+
+        /* check that the allocated object is not shared with other objects */
+        stack<Value *> stack;
+        set<Value *> visited;
+        /* the allocated object must be passed to the caller */
+        bool isPassed = false;
+
+        stack.push(callInst);
+        visited.insert(callInst);
+
+        while (!stack.empty()) {
+            Value *value = stack.top();
+            stack.pop();
+
+            for (Value::use_iterator j = value->use_begin(); j != value->use_end(); j++) {
+                User *user = *j;
+
+                bool isDerived = false;
+                if (!isLocalUse(value, user, isDerived, isPassed)) {
+                    return false;
+                }
+
+                if (isDerived && visited.find(user) == visited.end()) {
+                    stack.push(user);
+                    visited.insert(user);
+                }
+            }
+        }
+
+        if (!isPassed) {
+            /* e.g. a temporary buffer */
+            return false;
+        }
+
+        allocates = true;
+    }
+
+    return allocates;
+}
+
+bool HeapCloner::isLocalUse(Value *value, User *user, bool &isDerived, bool &isPassed) {
+    if (isa<ReturnInst>(user)) {
+        isPassed = true;
+        return true;
+    }
+
+    if (isa<LoadInst>(user) || isa<ICmpInst>(user)) {
+        return true;
+    }
+
+    if (isa<StoreInst>(user)) {
+        StoreInst *store = dyn_cast<StoreInst>(user);
+        if (store->getValueOperand() != value) {
+            /* initialization of the allocated object */
+            return true;
+        }
+
+        /* the object may be passed to the caller only through an argument */
+        if (!isArgumentPointer(store->getPointerOperand())) {
+            return false;
+        }
+
+        isPassed = true;
+        return true;
+    }
+
+    if (isa<CallInst>(user)) {
+        return isInitializer(value, dyn_cast<CallInst>(user));
+    }
+
+    if (isa<CastInst>(user) || isa<GetElementPtrInst>(user)) {
+        isDerived = true;
+        return true;
+    }
+
+    return false;
+}
+
+/* calls which only write to the allocated object (e.g. memset) */
+bool HeapCloner::isInitializer(Value *value, CallInst *callInst) {
+    MemSetInst *memSet = dyn_cast<MemSetInst>(callInst);
+    if (memSet) {
+        return memSet->getRawDest() == value;
+    }
+
+    Function *calledFunction = callInst->getCalledFunction();
+    if (!calledFunction || !calledFunction->isDeclaration()) {
+        return false;
+    }
+
+    if (!calledFunction->getName().equals("memset")) {
+        return false;
+    }
+
+    /* the result (the destination) is ignored, so the object must not flow elsewhere */
+    if (!callInst->use_empty()) {
+        return false;
+    }
+
+    return callInst->getArgOperand(0) == value && callInst->getArgOperand(1) != value;
+}
+
+bool HeapCloner::isArgumentPointer(Value *pointer) {
+    Value *value = pointer->stripPointerCasts();
+
+    while (isa<GetElementPtrInst>(value)) {
+        value = dyn_cast<GetElementPtrInst>(value)->getPointerOperand()->stripPointerCasts();
+    }
+
+    return isa<Argument>(value);
+}
+
+bool HeapCloner::cloneCallSites(Function *wrapper) {
+    vector<CallInst *> callSites;
+    getCallSites(wrapper, callSites);
+    if (callSites.size() <= 1) {
+        return false;
+    }
+
+    Function *origin = wrapper;
+    OriginMap::iterator entry = originMap.find(wrapper);
+    if (entry != originMap.end()) {
+        origin = entry->second;
+    }
+
+    bool changed = false;
+
+    /* the first call site keeps the wrapper */
+    for (unsigned int i = 1; i < callSites.size(); i++) {
+        CallInst *callInst = callSites[i];
+
+        uint32_t &count = cloneCountMap[origin];
+        if (count >= maxClones) {
+            debugs << "too many clones: " << origin->getName() << "\n";
+            break;
+        }
+
+        ValueToValueMapTy v2vmap;
+        Function *cloned = CloneFunction(wrapper, v2vmap, false);
+
+        string clonedName = origin->getName().str() + string("_heap_") + to_string(count++);
+        cloned->setName(StringRef(clonedName));
+        cloned->setLinkage(GlobalValue::InternalLinkage);
+        module->getFunctionList().push_back(cloned);
+
+        callInst->setCalledFunction(cloned);
+
+        wrappers.insert(cloned);
+        originMap[cloned] = origin;
+        changed = true;
+    }
+
+    return changed;
+}
+
+void HeapCloner::getCallSites(Function *f, vector<CallInst *> &callSites) {
+    for (Value::use_iterator i = f->use_begin(); i != f->use_end(); i++) {
+        CallInst *callInst = dyn_cast<CallInst>(*i);
+        if (!callInst || callInst->getCalledFunction() != f) {
+            continue;
+        }
+
+        callSites.push_back(callInst);
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef HEAPCLONER_H
+#define HEAPCLONER_H
+
+#include <stdio.h>
+#include <vector>
+#include <set>
+#include <map>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/raw_ostream.h>
+
+/*
+ * The pointer analysis has a single heap object per allocation site, so all the
+ * objects which are allocated by a wrapper (xmalloc, dict_init, ...) are merged.
+ * This pass gives each call site of a wrapper its own copy of the wrapper.
+ */
+class HeapCloner {
+public:
+
+    typedef std::set<llvm::Function *> FunctionSet;
+    typedef std::map<llvm::Function *, uint32_t> CloneCountMap;
+    typedef std::map<llvm::Function *, llvm::Function *> OriginMap;
+
+    HeapCloner(
+        llvm::Module *module,
+        std::vector<llvm::Function *> targets,
+        llvm::raw_ostream &debugs,
+        uint32_t maxClones = 100,
+        uint32_t maxSize = 50
+    ) :
+        module(module),
+        targets(targets.begin(), targets.end()),
+        isResolved(true),
+        debugs(debugs),
+        maxClones(maxClones),
+        maxSize(maxSize)
+    {
+
+    }
+
+    /* the names are resolved by run() */
+    HeapCloner(
+        llvm::Module *module,
+        std::vector<std::string> targets,
+        llvm::raw_ostream &debugs,
+        uint32_t maxClones = 100,
+        uint32_t maxSize = 50
+    ) :
+        module(module),
+        targetNames(targets),
+        isResolved(false),
+        debugs(debugs),
+        maxClones(maxClones),
+        maxSize(maxSize)
+    {
+
+    }
+
+    ~HeapCloner() {};
+
+    void run();
+
+    FunctionSet &getWrappers() {
+        return wrappers;
+    }
+
+private:
+
+    void resolveFunctions();
+
+    void findWrappers();
+
+    bool isAllocator(llvm::Function *f);
+
+    bool isWrapper(llvm::Function *f);
+
+    bool isLocalUse(llvm::Value *value, llvm::User *user, bool &isDerived, bool &isPassed);
+
+    bool isInitializer(llvm::Value *value, llvm::CallInst *callInst);
+
+    bool isArgumentPointer(llvm::Value *pointer);
+
+    bool cloneCallSites(llvm::Function *wrapper);
+
+    void getCallSites(llvm::Function *f, std::vector<llvm::CallInst *> &callSites);
+
+    llvm::Module *module;
+    FunctionSet targets;
+    /* the names which were passed to the constructor */
+    std::vector<std::string> targetNames;
+    bool isResolved;
+    llvm::raw_ostream &debugs;
+    /* the maximal number of clones per wrapper */
+    uint32_t maxClones;
+    /* the maximal number of instructions of a wrapper */
+    uint32_t maxSize;
+    FunctionSet wrappers;
+    /* maps a clone to the original wrapper */
+    OriginMap originMap;
+    CloneCountMap cloneCountMap;
+};
+
+#endif /* HEAPCLONER_H */
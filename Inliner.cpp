@@ -18,14 +18,39 @@
 using namespace std;
 using namespace llvm;
 
+void Inliner::resolveFunctions() {
+    if (isResolved) {
+        return;
+    }
+
+    targets = ReachabilityAnalysis::getFunctions(module, targetNames);
+
+    for (vector<string>::iterator i = functionNames.begin(); i != functionNames.end(); i++) {
+        Function *f = module->getFunction(*i);
+        if (!f) {
+            /* it may have been erased by the reachability analysis */
+            debugs << "WARNING: inlined function '" << *i << "' is not found\n";
+            continue;
+        }
+        functions.insert(f);
+    }
+
+    isResolved = true;
+}
+
 void Inliner::run() {
+    resolveFunctions();
+
     if (functions.empty()) {
         return;
     }
 
-    for (vector<string>::iterator i = targets.begin(); i != targets.end(); i++) {
-        Function *entry = module->getFunction(*i);
-        assert(entry);
+    for (unsigned int i = 0; i < targets.size(); i++) {
+        Function *entry = targets[i];
+        if (!entry) {
+            errs() << "function '" << targetNames[i] << "' is not found\n";
+            assert(false);
+        }
 
         /* we can't use pointer analysis at this point... */
         set<Function *> reachable;
@@ -36,12 +61,12 @@ void Inliner::run() {
                 continue;
             }
 
-            inlineCalls(f, functions);
+            inlineCalls(f);
         }
     }
 }
 
-void Inliner::inlineCalls(Function *f, vector<string> functions) {
+void Inliner::inlineCalls(Function *f) {
     vector<CallInst *> calls;
 
     for (inst_iterator i = inst_begin(f); i != inst_end(f); i++) {
@@ -57,7 +82,7 @@ void Inliner::inlineCalls(Function *f, vector<string> functions) {
             continue;
         }
 
-        if (find(functions.begin(), functions.end(), calledFunction->getName().str()) == functions.end()) {
+        if (functions.find(calledFunction) == functions.end()) {
             continue;
         }
 
@@ -3,8 +3,10 @@
 
 #include <stdio.h>
 #include <vector>
+#include <set>
 
 #include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
 #include <llvm/Support/raw_ostream.h>
 
 #include "ReachabilityAnalysis.h"
@@ -12,6 +14,25 @@
 class Inliner {
 public:
 
+    Inliner(
+        llvm::Module *module,
+        ReachabilityAnalysis *ra,
+        std::vector<llvm::Function *> targets,
+        std::vector<llvm::Function *> functions,
+        llvm::raw_ostream &debugs
+    ) :
+        module(module),
+        ra(ra),
+        targets(targets),
+        functions(functions.begin(), functions.end()),
+        targetNames(ReachabilityAnalysis::getNames(targets)),
+        isResolved(true),
+        debugs(debugs)
+    {
+
+    }
+
+    /* the names are resolved by run() */
     Inliner(
         llvm::Module *module,
         ReachabilityAnalysis *ra,
@@ -21,8 +42,9 @@ public:
     ) :
         module(module),
         ra(ra),
-        targets(targets),
-        functions(functions),
+        targetNames(targets),
+        functionNames(functions),
+        isResolved(false),
         debugs(debugs)
     {
 
@@ -33,13 +55,20 @@ public:
     void run();
 
 private:
-    
-    void inlineCalls(llvm::Function *f, std::vector<std::string> functions);
+
+    void resolveFunctions();
+
+    void inlineCalls(llvm::Function *f);
 
     llvm::Module *module;
     ReachabilityAnalysis *ra;
-    std::vector<std::string> targets;
-    std::vector<std::string> functions;
+    std::vector<llvm::Function *> targets;
+    /* the functions to inline */
+    std::set<llvm::Function *> functions;
+    /* used for diagnostics, and for resolving the functions if they were passed by name */
+    std::vector<std::string> targetNames;
+    std::vector<std::string> functionNames;
+    bool isResolved;
     llvm::raw_ostream &debugs;
 };
 
@@ -0,0 +1,77 @@
+#include <stdbool.h>
+#include <assert.h>
+#include <set>
+#include <map>
+
+#include <llvm/IR/Instruction.h>
+
+#include "InstructionSetPool.h"
+
+using namespace std;
+using namespace llvm;
+
+InstructionSetPool::InstructionSetRef InstructionSetPool::intern(const InstructionSet &s) {
+    if (s.empty()) {
+        return getEmpty();
+    }
+
+    /* the nodes of std::map are stable, so the address of the key can be used as a handle */
+    pair<RefCountMap::iterator, bool> result = pool.insert(make_pair(s, 0));
+    if (result.second) {
+        handles[&result.first->first] = result.first;
+    }
+    result.first->second++;
+    return &result.first->first;
+}
+
+InstructionSetPool::InstructionSetRef InstructionSetPool::merge(const set<InstructionSetRef> &sets) {
+    if (sets.empty()) {
+        return getEmpty();
+    }
+
+    /* no need to build a new set */
+    if (sets.size() == 1) {
+        return acquire(*sets.begin());
+    }
+
+    InstructionSet merged;
+    for (set<InstructionSetRef>::const_iterator i = sets.begin(); i != sets.end(); i++) {
+        InstructionSetRef s = *i;
+        merged.insert(s->begin(), s->end());
+    }
+
+    return intern(merged);
+}
+
+InstructionSetPool::InstructionSetRef InstructionSetPool::acquire(InstructionSetRef ref) {
+    if (ref == NULL || ref == &empty) {
+        return ref;
+    }
+
+    HandleMap::iterator handle = handles.find(ref);
+    assert(handle != handles.end());
+    handle->second->second++;
+    return ref;
+}
+
+void InstructionSetPool::release(InstructionSetRef ref) {
+    if (ref == NULL || ref == &empty) {
+        return;
+    }
+
+    HandleMap::iterator handle = handles.find(ref);
+    assert(handle != handles.end());
+    RefCountMap::iterator entry = handle->second;
+    if (--entry->second == 0) {
+        handles.erase(handle);
+        pool.erase(entry);
+    }
+}
+
+InstructionSetPool::InstructionSetRef InstructionSetPool::getEmpty() {
+    return &empty;
+}
+
+size_t InstructionSetPool::size() {
+    return pool.size();
+}
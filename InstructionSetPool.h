@@ -0,0 +1,53 @@
+#ifndef INSTRUCTIONSETPOOL_H
+#define INSTRUCTIONSETPOOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <set>
+#include <map>
+
+#include <llvm/IR/Instruction.h>
+
+/* holds a single (reference counted) copy of each distinct immutable instruction set */
+class InstructionSetPool {
+public:
+
+    typedef std::set<llvm::Instruction *> InstructionSet;
+    /* a shared handle, equal sets have equal handles */
+    typedef const InstructionSet *InstructionSetRef;
+
+    InstructionSetPool() {
+
+    }
+
+    ~InstructionSetPool() {};
+
+    /* the returned handle holds a reference (see release) */
+    InstructionSetRef intern(const InstructionSet &s);
+
+    /* returns the handle of the union of the given sets (holds a reference) */
+    InstructionSetRef merge(const std::set<InstructionSetRef> &sets);
+
+    /* take another reference to a handle */
+    InstructionSetRef acquire(InstructionSetRef ref);
+
+    /* the set is removed from the pool when its last reference is released */
+    void release(InstructionSetRef ref);
+
+    /* the empty set is not counted */
+    InstructionSetRef getEmpty();
+
+    size_t size();
+
+private:
+
+    typedef std::map<InstructionSet, uint32_t> RefCountMap;
+    /* acquire and release find the entries by handle, without comparing the sets */
+    typedef std::map<InstructionSetRef, RefCountMap::iterator> HandleMap;
+
+    RefCountMap pool;
+    HandleMap handles;
+    InstructionSet empty;
+};
+
+#endif /* INSTRUCTIONSETPOOL_H */
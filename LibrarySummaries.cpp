@@ -0,0 +1,112 @@
+#include <stdbool.h>
+#include <string.h>
+#include <vector>
+
+#include <llvm/IR/Value.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Instructions.h>
+
+#include "LibrarySummaries.h"
+
+using namespace std;
+using namespace llvm;
+
+static const LibrarySummaries::Summary summaries[] = {
+    /* intrinsics */
+    {"llvm.memcpy.", true, {0, -1}, {1, -1}},
+    {"llvm.memmove.", true, {0, -1}, {1, -1}},
+    {"llvm.memset.", true, {0, -1}, {-1}},
+    /* memory */
+    {"memcpy", false, {0, -1}, {1, -1}},
+    {"memmove", false, {0, -1}, {1, -1}},
+    {"memset", false, {0, -1}, {-1}},
+    {"bzero", false, {0, -1}, {-1}},
+    {"memcmp", false, {-1}, {0, 1, -1}},
+    {"memchr", false, {-1}, {0, -1}},
+    /* strings */
+    {"strcpy", false, {0, -1}, {1, -1}},
+    {"strncpy", false, {0, -1}, {1, -1}},
+    {"stpcpy", false, {0, -1}, {1, -1}},
+    {"strcat", false, {0, -1}, {0, 1, -1}},
+    {"strncat", false, {0, -1}, {0, 1, -1}},
+    {"strlen", false, {-1}, {0, -1}},
+    {"strnlen", false, {-1}, {0, -1}},
+    {"strcmp", false, {-1}, {0, 1, -1}},
+    {"strncmp", false, {-1}, {0, 1, -1}},
+    {"strchr", false, {-1}, {0, -1}},
+    {"strrchr", false, {-1}, {0, -1}},
+    {"strstr", false, {-1}, {0, 1, -1}},
+    /* formatted output (the variadic arguments are not summarized) */
+    {"sprintf", false, {0, -1}, {1, -1}},
+    {"snprintf", false, {0, -1}, {2, -1}},
+};
+
+bool LibrarySummaries::isModifier(Instruction *inst) {
+    const Summary *summary = getSummary(inst);
+    return summary && summary->modArgs[0] != -1;
+}
+
+bool LibrarySummaries::isReader(Instruction *inst) {
+    const Summary *summary = getSummary(inst);
+    return summary && summary->refArgs[0] != -1;
+}
+
+void LibrarySummaries::getModifiedPointers(Instruction *inst, vector<Value *> &result) {
+    const Summary *summary = getSummary(inst);
+    if (summary) {
+        getPointers(inst, summary->modArgs, result);
+    }
+}
+
+void LibrarySummaries::getReadPointers(Instruction *inst, vector<Value *> &result) {
+    const Summary *summary = getSummary(inst);
+    if (summary) {
+        getPointers(inst, summary->refArgs, result);
+    }
+}
+
+const LibrarySummaries::Summary *LibrarySummaries::getSummary(Instruction *inst) {
+    CallInst *callInst = dyn_cast<CallInst>(inst);
+    if (!callInst) {
+        return NULL;
+    }
+
+    /* indirect calls are not summarized */
+    Function *f = callInst->getCalledFunction();
+    if (!f || !f->isDeclaration()) {
+        return NULL;
+    }
+
+    const char *name = f->getName().data();
+    for (unsigned int i = 0; i < sizeof(summaries) / sizeof(summaries[0]); i++) {
+        const Summary &summary = summaries[i];
+        if (summary.isPrefix) {
+            if (strncmp(name, summary.name, strlen(summary.name)) == 0) {
+                return &summary;
+            }
+        } else {
+            if (f->getName() == summary.name) {
+                return &summary;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+void LibrarySummaries::getPointers(Instruction *inst, const int *args, vector<Value *> &result) {
+    CallInst *callInst = dyn_cast<CallInst>(inst);
+
+    for (unsigned int i = 0; args[i] != -1; i++) {
+        unsigned int index = args[i];
+        if (index >= callInst->getNumArgOperands()) {
+            continue;
+        }
+
+        Value *arg = callInst->getArgOperand(index);
+        if (arg->getType()->isPointerTy()) {
+            result.push_back(arg);
+        }
+    }
+}
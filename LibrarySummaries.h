@@ -0,0 +1,44 @@
+#ifndef LIBRARYSUMMARIES_H
+#define LIBRARYSUMMARIES_H
+
+#include <stdbool.h>
+#include <vector>
+
+#include <llvm/IR/Value.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Instructions.h>
+
+/* built-in mod/ref summaries of intrinsics and common library functions */
+class LibrarySummaries {
+public:
+
+    /* the maximal number of summarized arguments (per side) */
+    static const unsigned int MaxArgs = 2;
+
+    struct Summary {
+        const char *name;
+        /* match all the overloads of an intrinsic (llvm.memcpy.*) */
+        bool isPrefix;
+        /* the indices of the pointer arguments (terminated by -1) */
+        int modArgs[MaxArgs + 1];
+        int refArgs[MaxArgs + 1];
+    };
+
+    /* a call which writes to memory through its arguments */
+    static bool isModifier(llvm::Instruction *inst);
+
+    /* a call which reads from memory through its arguments */
+    static bool isReader(llvm::Instruction *inst);
+
+    static void getModifiedPointers(llvm::Instruction *inst, std::vector<llvm::Value *> &result);
+
+    static void getReadPointers(llvm::Instruction *inst, std::vector<llvm::Value *> &result);
+
+private:
+
+    static const Summary *getSummary(llvm::Instruction *inst);
+
+    static void getPointers(llvm::Instruction *inst, const int *args, std::vector<llvm::Value *> &result);
+};
+
+#endif /* LIBRARYSUMMARIES_H */
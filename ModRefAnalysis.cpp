@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <iostream>
+#include <algorithm>
 #include <vector>
+#include <stack>
 #include <set>
 #include <map>
 
@@ -16,9 +18,12 @@
 #include "MemoryModel/PointerAnalysis.h"
 #include "MSSA/MemRegion.h"
 #include "MSSA/MemPartition.h"
+#include "MSSA/SVFG.h"
+#include "MSSA/SVFGBuilder.h"
 
 #include "AAPass.h"
 #include "ModRefAnalysis.h"
+#include "LibrarySummaries.h"
 
 using namespace std;
 using namespace llvm;
@@ -29,15 +34,39 @@ ModRefAnalysis::ModRefAnalysis(
     llvm::Module *module,
     ReachabilityAnalysis *ra,
     AAPass *aa,
-    string entry,
-    vector<string> targets,
-    llvm::raw_ostream &debugs
+    Function *entry,
+    vector<Function *> targets,
+    llvm::raw_ostream &debugs,
+    bool lazyMode
 ) :
-    module(module), ra(ra), aa(aa), entry(entry), targets(targets), debugs(debugs)
+    module(module),
+    ra(ra),
+    aa(aa),
+    entryName(entry ? entry->getName().str() : ""),
+    targetNames(ReachabilityAnalysis::getNames(targets)),
+    isResolved(true),
+    entryFunction(entry),
+    targetFunctions(targets),
+    nextSliceId(1),
+    debugs(debugs),
+    lazyMode(lazyMode),
+    svfgMode(false),
+    svfgBuilder(NULL),
+    svfg(NULL),
+    ptsLimit(0),
+    callSiteMode(false),
+    statisticsMode(false),
+    isAnalyzed(false),
+    isReleased(false)
 {
 
 }
 
+ModRefAnalysis::~ModRefAnalysis() {
+    /* the builder owns the SVFG */
+    delete svfgBuilder;
+}
+
 Function *ModRefAnalysis::getEntry() {
     return entryFunction;
 }
@@ -46,21 +75,33 @@ vector<Function *> ModRefAnalysis::getTargets() {
     return targetFunctions;
 }
 
+void ModRefAnalysis::resolveFunctions() {
+    if (isResolved) {
+        return;
+    }
+
+    entryFunction = module->getFunction(entryName);
+    targetFunctions = ReachabilityAnalysis::getFunctions(module, targetNames);
+    isResolved = true;
+}
+
 void ModRefAnalysis::run() {
+    resolveFunctions();
+
     /* validation */
-    entryFunction = module->getFunction(entry);
     if (!entryFunction) {
-        errs() << "entry function '" << entry << "' is not found (or unreachable)\n";
+        errs() << "entry function '" << entryName << "' is not found (or unreachable)\n";
         assert(false);
     }
-    for (vector<string>::iterator i = targets.begin(); i != targets.end(); i++) {
-        string name = *i;
-        Function *f = module->getFunction(name);
-        if (!f) {
-            errs() << "function '" << name << "' is not found (or unreachable)\n";
+    for (unsigned int i = 0; i < targetFunctions.size(); i++) {
+        if (!targetFunctions[i]) {
+            errs() << "function '" << targetNames[i] << "' is not found (or unreachable)\n";
             assert(false);
         }
-        targetFunctions.push_back(f);
+    }
+    if (callSiteMode && lazyMode) {
+        errs() << "call-site mode is not supported in lazy mode\n";
+        assert(false);
     }
 
     /* collect mod information for each target function */
@@ -75,32 +116,249 @@ void ModRefAnalysis::run() {
         collectRefInfo(f);
     }
 
+    if (svfgMode) {
+        buildSVFG();
+    }
+
     /* compute the side effects of each target function */
     computeModRefInfo();
 
+    /* compute the stores which may override the side effects */
+    computeOverridingStores();
+
     /* for each modified object compute the modifying store instructions */
     computeModInfoToStoreMap();
 
+    isAnalyzed = true;
+
     /* debug */
     dumpModSetMap();
+    if (statisticsMode) {
+        /* computes the points-to set of each load and store again */
+        dumpStatistics();
+    }
     //dumpLoadToStoreMap();
     //dumpLoadToModInfoMap();
     //dumpModInfoToStoreMap();
     //dumpModInfoToIdMap();
+    //dumpLoadToCallSiteModInfoMap();
     //dumpOverridingStores();
 }
 
+void ModRefAnalysis::addTarget(Function *f) {
+    /* otherwise, run() would analyze the target again */
+    assert(isAnalyzed);
+    assert(!isReleased);
+
+    if (find(targetFunctions.begin(), targetFunctions.end(), f) != targetFunctions.end()) {
+        /* already analyzed */
+        return;
+    }
+
+    targetFunctions.push_back(f);
+    targetNames.push_back(f->getName().str());
+
+    if (svfgMode && !svfg) {
+        buildSVFG();
+    }
+
+    /* the reachability analysis must be aware of the new target */
+    ra->addTarget(f);
+
+    collectModInfo(f);
+    collectRefInfo(f);
+    computeModRefInfo(f);
+
+    /* the ref information of the new target may affect the other targets */
+    computeOverridingStores();
+
+    /* new slice id's are allocated only for the added target */
+    computeModInfoToStoreMap(f);
+}
+
+void ModRefAnalysis::removeTarget(Function *f) {
+    assert(isAnalyzed);
+    assert(!isReleased);
+
+    vector<Function *>::iterator entry = find(targetFunctions.begin(), targetFunctions.end(), f);
+    if (entry == targetFunctions.end()) {
+        return;
+    }
+
+    targetNames.erase(targetNames.begin() + (entry - targetFunctions.begin()));
+    targetFunctions.erase(entry);
+
+    /* a later addTarget must not use the stale reachability information */
+    ra->removeTarget(f);
+
+    /* collect the loads which were affected by the removed target */
+    InstructionSet affected;
+    ObjToLoadMap::iterator li = objToLoadMap.lower_bound(make_pair(f, (NodeID)(0)));
+    while (li != objToLoadMap.end() && li->first.first == f) {
+        affected.insert(li->second.begin(), li->second.end());
+        objToLoadMap.erase(li++);
+    }
+
+    ObjToStoreMap::iterator si = objToStoreMap.lower_bound(make_pair(f, (NodeID)(0)));
+    while (si != objToStoreMap.end() && si->first.first == f) {
+        pool.release(si->second);
+        objToStoreMap.erase(si++);
+    }
+
+    ObjToLoadMap::iterator vi = observingLoadsMap.lower_bound(make_pair(f, (NodeID)(0)));
+    while (vi != observingLoadsMap.end() && vi->first.first == f) {
+        observingLoadsMap.erase(vi++);
+    }
+
+    ObjToOverridingStoreMap::iterator oi = objToOverridingStoreMap.lower_bound(make_pair(f, (NodeID)(0)));
+    while (oi != objToOverridingStoreMap.end() && oi->first.first == f) {
+        objToOverridingStoreMap.erase(oi++);
+    }
+
+    removeCallSites(f);
+
+    modPtsMap.erase(f);
+    refPtsMap.erase(f);
+    ModSetMap::iterator ms = modSetMap.find(f);
+    if (ms != modSetMap.end()) {
+        pool.release(ms->second);
+        modSetMap.erase(ms);
+    }
+    refLoadsMap.erase(f);
+    refStoresMap.erase(f);
+
+    if (lazyMode) {
+        /* the memoized queries may depend on the removed target */
+        resetQueries();
+    } else {
+        /* the loads may still be affected by the other targets */
+        for (InstructionSet::iterator i = affected.begin(); i != affected.end(); i++) {
+            updateLoadInfo(*i);
+        }
+    }
+
+    computeOverridingStores();
+
+    /* drop the side effects of the removed target (the other slice id's are kept) */
+    retSliceIdMap.erase(f);
+
+    ModInfoToStoreMap::iterator mi = modInfoToStoreMap.lower_bound(make_pair(f, AllocSite(NULL, 0)));
+    while (mi != modInfoToStoreMap.end() && mi->first.first == f) {
+        pool.release(mi->second);
+        modInfoToStoreMap.erase(mi++);
+    }
+
+    ModInfoToIdMap::iterator ii = modInfoToIdMap.lower_bound(make_pair(f, AllocSite(NULL, 0)));
+    while (ii != modInfoToIdMap.end() && ii->first.first == f) {
+        modInfoToIdMap.erase(ii++);
+    }
+
+    SideEffects::iterator ei = sideEffects.begin();
+    while (ei != sideEffects.end()) {
+        if (ei->getFunction() == f) {
+            ei = sideEffects.erase(ei);
+        } else {
+            ei++;
+        }
+    }
+}
+
+void ModRefAnalysis::removeCallSites(Function *f) {
+    CallSitesMap::iterator entry = callSitesMap.find(f);
+    if (entry == callSitesMap.end()) {
+        return;
+    }
+
+    vector<Instruction *> &callSites = entry->second;
+    for (vector<Instruction *>::iterator i = callSites.begin(); i != callSites.end(); i++) {
+        Instruction *callSite = *i;
+
+        callSiteRefPtsMap.erase(callSite);
+        CallSiteModSetMap::iterator ms = callSiteModSetMap.find(callSite);
+        if (ms != callSiteModSetMap.end()) {
+            pool.release(ms->second);
+            callSiteModSetMap.erase(ms);
+        }
+
+        CallSiteObjToLoadMap::iterator li = callSiteObjToLoadMap.lower_bound(make_pair(callSite, (NodeID)(0)));
+        while (li != callSiteObjToLoadMap.end() && li->first.first == callSite) {
+            callSiteObjToLoadMap.erase(li++);
+        }
+
+        CallSiteModInfo first = make_pair(callSite, make_pair((Function *)(NULL), AllocSite(NULL, 0)));
+
+        CallSiteModInfoToStoreMap::iterator mi = callSiteModInfoToStoreMap.lower_bound(first);
+        while (mi != callSiteModInfoToStoreMap.end() && mi->first.first == callSite) {
+            pool.release(mi->second);
+            callSiteModInfoToStoreMap.erase(mi++);
+        }
+
+        CallSiteModInfoToIdMap::iterator ii = callSiteModInfoToIdMap.lower_bound(first);
+        while (ii != callSiteModInfoToIdMap.end() && ii->first.first == callSite) {
+            callSiteModInfoToIdMap.erase(ii++);
+        }
+    }
+
+    for (LoadToCallSiteModInfoMap::iterator i = loadToCallSiteModInfoMap.begin(); i != loadToCallSiteModInfoMap.end(); i++) {
+        set<CallSiteModInfo> &modInfos = i->second;
+        set<CallSiteModInfo>::iterator j = modInfos.begin();
+        while (j != modInfos.end()) {
+            if (j->second.first == f) {
+                modInfos.erase(j++);
+            } else {
+                j++;
+            }
+        }
+    }
+
+    callSitesMap.erase(entry);
+}
+
+void ModRefAnalysis::releaseBuildState() {
+    /* the lazy queries use all the maps */
+    assert(!lazyMode);
+
+    modPtsMap.clear();
+    clearStores(objToStoreMap);
+    refPtsMap.clear();
+    objToLoadMap.clear();
+    objToOverridingStoreMap.clear();
+    clearStores(modSetMap);
+    cache.clear();
+    observingLoadsMap.clear();
+
+    callSitesMap.clear();
+    callSiteRefPtsMap.clear();
+    callSiteObjToLoadMap.clear();
+    clearStores(callSiteModSetMap);
+
+    /* the builder owns the SVFG */
+    delete svfgBuilder;
+    svfgBuilder = NULL;
+    svfg = NULL;
+
+    isReleased = true;
+}
+
 ModRefAnalysis::ModInfoToStoreMap &ModRefAnalysis::getModInfoToStoreMap() {
     return modInfoToStoreMap;
 }
 
 bool ModRefAnalysis::mayBlock(Instruction *load) {
+    if (lazyMode) {
+        computeLoadInfo(load);
+    }
+
     LoadToStoreMap::iterator i = loadToStoreMap.find(load);
     return i != loadToStoreMap.end();
 }
 
 bool ModRefAnalysis::mayOverride(Instruction *store) {
-    InstructionSet::iterator i = find(overridingStores.begin(), overridingStores.end(), store);
+    if (lazyMode) {
+        return computeMayOverride(store);
+    }
+
+    InstructionSet::iterator i = overridingStores.find(store);
     return i != overridingStores.end();
 }
 
@@ -109,6 +367,16 @@ ModRefAnalysis::SideEffects &ModRefAnalysis::getSideEffects() {
 }
 
 ModRefAnalysis::InstructionSet &ModRefAnalysis::getOverridingStores() {
+    if (lazyMode) {
+        /* resolve all the pending queries */
+        for (RefSetMap::iterator i = refStoresMap.begin(); i != refStoresMap.end(); i++) {
+            InstructionSet &stores = i->second;
+            for (InstructionSet::iterator j = stores.begin(); j != stores.end(); j++) {
+                computeMayOverride(*j);
+            }
+        }
+    }
+
     return overridingStores;
 }
 
@@ -116,6 +384,14 @@ ModRefAnalysis::ModInfoToIdMap &ModRefAnalysis::getModInfoToIdMap() {
     return modInfoToIdMap;
 }
 
+ModRefAnalysis::CallSiteModInfoToStoreMap &ModRefAnalysis::getCallSiteModInfoToStoreMap() {
+    return callSiteModInfoToStoreMap;
+}
+
+ModRefAnalysis::CallSiteModInfoToIdMap &ModRefAnalysis::getCallSiteModInfoToIdMap() {
+    return callSiteModInfoToIdMap;
+}
+
 bool ModRefAnalysis::getRetSliceId(llvm::Function *f, uint32_t &id) {
     RetSliceIdMap::iterator i = retSliceIdMap.find(f);
     if (i == retSliceIdMap.end()) {
@@ -128,6 +404,7 @@ bool ModRefAnalysis::getRetSliceId(llvm::Function *f, uint32_t &id) {
 
 void ModRefAnalysis::collectModInfo(Function *entry) {
     set<Function *> &reachable = ra->getReachableFunctions(entry);
+    ObjToStoreSetMap objStores;
 
     for (set<Function *>::iterator i = reachable.begin(); i != reachable.end(); i++) {
         Function *f = *i;
@@ -137,23 +414,29 @@ void ModRefAnalysis::collectModInfo(Function *entry) {
 
         for (inst_iterator j = inst_begin(f); j != inst_end(f); j++) {
             Instruction *inst = &*j;
-            if (inst->getOpcode() == Instruction::Store) {
-                addStore(entry, inst);
-            } 
+            if (modifiesMemory(inst)) {
+                addStore(entry, inst, objStores);
+            }
         }
     }
 
+    /* the store sets are not modified from now on */
+    for (ObjToStoreSetMap::iterator i = objStores.begin(); i != objStores.end(); i++) {
+        pair<Function *, NodeID> k = make_pair(entry, i->first);
+        setStores(objToStoreMap[k], pool.intern(i->second));
+    }
+
     /* we don't need it any more... */
     cache.clear();
 }
 
 void ModRefAnalysis::addStore(
     Function *f,
-    Instruction *store
+    Instruction *store,
+    ObjToStoreSetMap &objStores
 ) {
-    AliasAnalysis::Location storeLocation = getStoreLocation(dyn_cast<StoreInst>(store));
-    NodeID id = aa->getPTA()->getPAG()->getValueNode(storeLocation.Ptr);
-    PointsTo &pts = aa->getPTA()->getPts(id);
+    PointsTo pts;
+    getModifiedPts(store, pts);
 
     PointsTo &modPts = modPtsMap[f];
 
@@ -168,7 +451,11 @@ void ModRefAnalysis::addStore(
             assert(false);
         }
 
-        /* TODO: check static objects? */
+        /* a store can't modify a read-only object (even if the pointer analysis says so) */
+        if (isReadOnlyObject(obj->getMemObj()->getRefVal())) {
+            continue;
+        }
+
         if (obj->getMemObj()->isStack()) {
             const Value *value = obj->getMemObj()->getRefVal();
             if (canIgnoreStackObject(f, value)) {
@@ -176,12 +463,31 @@ void ModRefAnalysis::addStore(
             }
         }
 
-        pair<Function *, NodeID> k = make_pair(f, nodeId);
-        objToStoreMap[k].insert(store);
+        objStores[nodeId].insert(store);
         modPts.set(nodeId);
     }
 }
 
+/* the object can't be modified after it was initialized */
+bool ModRefAnalysis::isReadOnlyObject(const Value *value) {
+    if (!value) {
+        return false;
+    }
+
+    /* the memory of a function is never written */
+    if (isa<Function>(value)) {
+        return true;
+    }
+
+    /* writing to a constant global (e.g. a string literal) is undefined */
+    const GlobalVariable *gv = dyn_cast<GlobalVariable>(value);
+    if (gv && gv->isConstant()) {
+        return true;
+    }
+
+    return false;
+}
+
 bool ModRefAnalysis::canIgnoreStackObject(
     Function *f,
     const Value *value
@@ -192,6 +498,28 @@ bool ModRefAnalysis::canIgnoreStackObject(
         return false;
     }
 
+    /* a non-escaping object is accessed only by the activation which allocated it */
+    EscapeAnalysis::EscapeKind kind = escapeAnalysis.getEscapeKind(alloca);
+    if (kind == EscapeAnalysis::NoEscape) {
+        return true;
+    }
+
+    /* the callees can't keep the address, so if none of them is defined (e.g. library
+       functions), the object is accessed only by the allocating activation as well */
+    if (kind == EscapeAnalysis::DownwardEscape) {
+        EscapeAnalysis::FunctionSet &callees = escapeAnalysis.getCallees(alloca);
+        bool isDefined = false;
+        for (EscapeAnalysis::FunctionSet::iterator i = callees.begin(); i != callees.end(); i++) {
+            if (!(*i)->isDeclaration()) {
+                isDefined = true;
+                break;
+            }
+        }
+        if (!isDefined) {
+            return true;
+        }
+    }
+
     /* get the allocating function */
     Function *allocatingFunction = dyn_cast<Function>(alloca->getParent()->getParent());
 
@@ -235,26 +563,66 @@ void ModRefAnalysis::collectRefInfo(Function *entry) {
     for (set<Instruction *>::iterator i = reachable.begin(); i != reachable.end(); i++) {
         Instruction *inst = *i;
 
-        /* handle load */
-        if (inst->getOpcode() == Instruction::Load) {
+        /* handle load (or a summarized call which reads memory) */
+        if (readsMemory(inst)) {
             addLoad(entry, inst);
         }
 
-        /* handle store */
-        if (inst->getOpcode() == Instruction::Store) {
-            addOverridingStore(inst);
+        /* handle store (or a summarized call which writes memory) */
+        if (modifiesMemory(inst)) {
+            addOverridingStore(entry, inst);
+        }
+    }
+
+    if (callSiteMode) {
+        /* the ref information of each call site (in addition to their union) */
+        vector<Instruction *> &relevant = callSitesMap[entry];
+        for (vector<CallInst *>::iterator i = callSites.begin(); i != callSites.end(); i++) {
+            relevant.push_back(*i);
+            collectCallSiteRefInfo(*i);
+        }
+    }
+}
+
+void ModRefAnalysis::collectCallSiteRefInfo(Instruction *callSite) {
+    vector<CallInst *> callSites;
+    callSites.push_back(dyn_cast<CallInst>(callSite));
+
+    set<Instruction *> reachable;
+    ra->getReachableInstructions(callSites, reachable);
+
+    PointsTo &refPts = callSiteRefPtsMap[callSite];
+
+    for (set<Instruction *>::iterator i = reachable.begin(); i != reachable.end(); i++) {
+        Instruction *load = *i;
+        if (!readsMemory(load)) {
+            continue;
+        }
+
+        PointsTo pts;
+        getReferencedPts(load, pts);
+        refPts |= pts;
+
+        for (PointsTo::iterator ni = pts.begin(); ni != pts.end(); ++ni) {
+            pair<Instruction *, NodeID> k = make_pair(callSite, *ni);
+            callSiteObjToLoadMap[k].insert(load);
         }
     }
 }
 
 void ModRefAnalysis::addLoad(Function *f, Instruction *load) {
-    AliasAnalysis::Location loadLocation = getLoadLocation(dyn_cast<LoadInst>(load));
-    NodeID id = aa->getPTA()->getPAG()->getValueNode(loadLocation.Ptr);
-    PointsTo &pts = aa->getPTA()->getPts(id);
+    PointsTo pts;
+    getReferencedPts(load, pts);
 
     PointsTo &refPts = refPtsMap[f];
     refPts |= pts;
 
+    if (lazyMode) {
+        /* the object to load mapping is computed on demand */
+        refLoadsMap[f].insert(load);
+        return;
+    }
+
     for (PointsTo::iterator i = pts.begin(); i != pts.end(); ++i) {
         NodeID nodeId = *i;
         pair<Function *, NodeID> k = make_pair(f, nodeId);
@@ -262,109 +630,604 @@ void ModRefAnalysis::addLoad(Function *f, Instruction *load) {
     }
 }
 
-void ModRefAnalysis::addOverridingStore(Instruction *store) {
-    AliasAnalysis::Location storeLocation = getStoreLocation(dyn_cast<StoreInst>(store));
-    NodeID id = aa->getPTA()->getPAG()->getValueNode(storeLocation.Ptr);
-    PointsTo &pts = aa->getPTA()->getPts(id);
+void ModRefAnalysis::addOverridingStore(Function *f, Instruction *store) {
+    if (lazyMode) {
+        refStoresMap[f].insert(store);
+        return;
+    }
+
+    PointsTo pts;
+    getModifiedPts(store, pts);
 
     for (PointsTo::iterator i = pts.begin(); i != pts.end(); ++i) {
         NodeID nodeId = *i;
-        objToOverridingStoreMap[nodeId].insert(store);
+        pair<Function *, NodeID> k = make_pair(f, nodeId);
+        objToOverridingStoreMap[k].insert(store);
     }
 }
 
 void ModRefAnalysis::computeModRefInfo() {
     for (ModPtsMap::iterator i = modPtsMap.begin(); i != modPtsMap.end(); i++) {
         Function *f = i->first;
-        PointsTo &modPts = i->second;
+        computeModRefInfo(f);
+    }
+}
+
+void ModRefAnalysis::computeModRefInfo(Function *f) {
+    ModPtsMap::iterator entry = modPtsMap.find(f);
+    if (entry == modPtsMap.end()) {
+        /* the function does not modify anything */
+        return;
+    }
+
+    PointsTo &modPts = entry->second;
+    /* get the corresponding ref-set */
+    PointsTo &refPts = refPtsMap[f];
+    /* compute the intersection */
+    PointsTo pts = modPts & refPts;
+    /* the modifies-set (interned when done) */
+    InstructionSet modSet;
+    /* the store sets which affect each load (merged when done) */
+    LoadToStoreRefsMap loadToStoreRefs;
+
+    for (PointsTo::iterator ni = pts.begin(); ni != pts.end(); ++ni) {
+        NodeID nodeId = *ni;
+
+        /* set key */
+        pair<Function *, NodeID> k = make_pair(f, nodeId);
+
+        if (svfgMode && !hasObservingLoad(f, nodeId)) {
+            /* the modification can't be observed after the call site */
+            continue;
+        }
+
+        /* update modifies-set */
+        InstructionSetRef stores = getStores(f, nodeId);
+        modSet.insert(stores->begin(), stores->end());
+
+        if (lazyMode) {
+            /* the loads are handled on demand */
+            continue;
+        }
+
+        /* get the modified allocation sites */
+        set<ModInfo> modInfos;
+        getModInfos(f, nodeId, stores, modInfos);
+
+        InstructionSet &loads = objToLoadMap[k];
+        for (InstructionSet::iterator i = loads.begin(); i != loads.end(); i++) {
+            Instruction *load = *i;
+
+            if (svfgMode && !isObservedBy(f, nodeId, load)) {
+                continue;
+            }
+
+            /* update with store instructions */
+            loadToStoreRefs[load].insert(stores);
 
-        /* get the corresponding ref-set */
-        PointsTo &refPts = refPtsMap[f];
-        /* compute the intersection */
-        PointsTo pts = modPts & refPts;
-        /* get the corresponding modifies-set */
-        InstructionSet &modSet = modSetMap[f];
+            /* update with allocation sites */
+            loadToModInfoMap[load].insert(modInfos.begin(), modInfos.end());
+        }
+    }
+
+    setStores(modSetMap[f], pool.intern(modSet));
+
+    for (LoadToStoreRefsMap::iterator i = loadToStoreRefs.begin(); i != loadToStoreRefs.end(); i++) {
+        Instruction *load = i->first;
+        set<InstructionSetRef> &refs = i->second;
+
+        /* the load may be already affected by other targets */
+        LoadToStoreMap::iterator current = loadToStoreMap.find(load);
+        if (current != loadToStoreMap.end()) {
+            refs.insert(current->second);
+        }
+
+        setStores(loadToStoreMap[load], pool.merge(refs));
+    }
+
+    if (callSiteMode) {
+        computeCallSiteModRefInfo(f);
+    }
+}
+
+/* same as computeModRefInfo, but with respect to the ref-set of each call site */
+void ModRefAnalysis::computeCallSiteModRefInfo(Function *f) {
+    PointsTo &modPts = modPtsMap[f];
+    vector<Instruction *> &callSites = callSitesMap[f];
+
+    for (vector<Instruction *>::iterator i = callSites.begin(); i != callSites.end(); i++) {
+        Instruction *callSite = *i;
+
+        PointsTo pts = modPts & callSiteRefPtsMap[callSite];
+        /* the store sets which form the modifies-set of the call site */
+        set<InstructionSetRef> refs;
 
         for (PointsTo::iterator ni = pts.begin(); ni != pts.end(); ++ni) {
             NodeID nodeId = *ni;
 
-            /* set key */
-            pair<Function *, NodeID> k = make_pair(f, nodeId);
+            if (svfgMode && !hasObservingLoad(f, nodeId)) {
+                continue;
+            }
+
+            InstructionSetRef stores = getStores(f, nodeId);
+            refs.insert(stores);
 
-            /* update modifies-set */
-            InstructionSet &stores = objToStoreMap[k];
-            modSet.insert(stores.begin(), stores.end());
+            set<ModInfo> modInfos;
+            getModInfos(f, nodeId, stores, modInfos);
 
-            /* get allocation site */
-            AllocSite allocSite = getAllocSite(nodeId);
+            CallSiteObjToLoadMap::iterator li = callSiteObjToLoadMap.find(make_pair(callSite, nodeId));
+            if (li == callSiteObjToLoadMap.end()) {
+                continue;
+            }
 
-            InstructionSet &loads = objToLoadMap[k];
-            for (InstructionSet::iterator i = loads.begin(); i != loads.end(); i++) {
-                Instruction *load = *i;
+            InstructionSet &loads = li->second;
+            for (InstructionSet::iterator j = loads.begin(); j != loads.end(); j++) {
+                Instruction *load = *j;
 
-                /* update with store instructions */
-                loadToStoreMap[load].insert(stores.begin(), stores.end());
+                if (svfgMode && !isObservedBy(f, nodeId, load)) {
+                    continue;
+                }
 
-                /* update with allocation site */
-                ModInfo modInfo = make_pair(f, allocSite);
-                loadToModInfoMap[load].insert(modInfo);
+                for (set<ModInfo>::iterator mi = modInfos.begin(); mi != modInfos.end(); mi++) {
+                    loadToCallSiteModInfoMap[load].insert(make_pair(callSite, *mi));
+                }
             }
+        }
+
+        setStores(callSiteModSetMap[callSite], pool.merge(refs));
+    }
+}
+
+void ModRefAnalysis::computeOverridingStores() {
+    /* the objects which are modified by some target and referenced after it */
+    modRefPts.clear();
+    for (ModPtsMap::iterator i = modPtsMap.begin(); i != modPtsMap.end(); i++) {
+        Function *f = i->first;
+        PointsTo &modPts = i->second;
+        modRefPts |= modPts & refPtsMap[f];
+    }
+
+    if (lazyMode) {
+        /* the overriding stores are computed on demand */
+        resetQueries();
+        return;
+    }
 
-            /* update overriding stores */
-            InstructionSet &localOverridingStores = objToOverridingStoreMap[nodeId];
-            overridingStores.insert(localOverridingStores.begin(), localOverridingStores.end());
+    /* the overriding stores may be found after the call site of any target */
+    overridingStores.clear();
+    for (ObjToOverridingStoreMap::iterator i = objToOverridingStoreMap.begin(); i != objToOverridingStoreMap.end(); i++) {
+        NodeID nodeId = i->first.second;
+        if (!modRefPts.test(nodeId)) {
+            continue;
         }
+
+        InstructionSet &localOverridingStores = i->second;
+        overridingStores.insert(localOverridingStores.begin(), localOverridingStores.end());
     }
 }
 
-void ModRefAnalysis::computeModInfoToStoreMap() {
-    uint32_t sliceId = 1;
+/* recompute the information of a single load from the remaining targets */
+void ModRefAnalysis::updateLoadInfo(Instruction *load) {
+    LoadToStoreMap::iterator current = loadToStoreMap.find(load);
+    if (current != loadToStoreMap.end()) {
+        pool.release(current->second);
+        loadToStoreMap.erase(current);
+    }
+    loadToModInfoMap.erase(load);
+
+    PointsTo pts;
+    getReferencedPts(load, pts);
+    set<InstructionSetRef> refs;
 
     for (vector<Function *>::iterator i = targetFunctions.begin(); i != targetFunctions.end(); i++) {
         Function *f = *i;
-        InstructionSet &modSet = modSetMap[f];
-
-        uint32_t retSliceId = sliceId++;
-        if (hasReturnValue(f)) {
-            retSliceIdMap[f] = retSliceId;
-            SideEffect sideEffect = {
-                .type = ReturnValue,
-                .id = retSliceId,
-                .info = {
-                    .f = f
+
+        ModPtsMap::iterator entry = modPtsMap.find(f);
+        if (entry == modPtsMap.end()) {
+            continue;
+        }
+
+        if (lazyMode) {
+            /* check if the load is reachable from the call sites of the target */
+            InstructionSet &refLoads = refLoadsMap[f];
+            if (refLoads.find(load) == refLoads.end()) {
+                continue;
+            }
+        }
+
+        PointsTo localModRefPts = entry->second & refPtsMap[f];
+        localModRefPts &= pts;
+
+        for (PointsTo::iterator ni = localModRefPts.begin(); ni != localModRefPts.end(); ++ni) {
+            NodeID nodeId = *ni;
+            pair<Function *, NodeID> k = make_pair(f, nodeId);
+
+            if (!lazyMode) {
+                ObjToLoadMap::iterator li = objToLoadMap.find(k);
+                if (li == objToLoadMap.end() || li->second.find(load) == li->second.end()) {
+                    continue;
                 }
-            };
-            sideEffects.push_back(sideEffect);
+            }
+
+            if (svfgMode && !isObservedBy(f, nodeId, load)) {
+                continue;
+            }
+
+            InstructionSetRef stores = getStores(f, nodeId);
+            refs.insert(stores);
+
+            set<ModInfo> modInfos;
+            getModInfos(f, nodeId, stores, modInfos);
+            loadToModInfoMap[load].insert(modInfos.begin(), modInfos.end());
         }
+    }
 
-        for (InstructionSet::iterator i = modSet.begin(); i != modSet.end(); i++) {
-            Instruction *store = *i;
-            AliasAnalysis::Location storeLocation = getStoreLocation(dyn_cast<StoreInst>(store));
-            NodeID id = aa->getPTA()->getPAG()->getValueNode(storeLocation.Ptr);
-            PointsTo &pts = aa->getPTA()->getPts(id);
+    if (!refs.empty()) {
+        setStores(loadToStoreMap[load], pool.merge(refs));
+    }
+}
 
-            for (PointsTo::iterator ni = pts.begin(); ni != pts.end(); ++ni) {
-                NodeID nodeId = *ni;
+/* compute the information of a load only once (lazy mode) */
+void ModRefAnalysis::computeLoadInfo(Instruction *load) {
+    if (queriedLoads.find(load) != queriedLoads.end()) {
+        return;
+    }
 
-                /* update store instructions */
-                AllocSite allocSite = getAllocSite(nodeId);
-                ModInfo modInfo = make_pair(f, allocSite);
-                modInfoToStoreMap[modInfo].insert(store);
+    updateLoadInfo(load);
+    queriedLoads.insert(load);
+}
 
-                if (modInfoToIdMap.find(modInfo) == modInfoToIdMap.end()) {
-                    uint32_t modSliceId = sliceId++;
-                    modInfoToIdMap[modInfo] = modSliceId;
+bool ModRefAnalysis::computeMayOverride(Instruction *store) {
+    OverridingCache::iterator entry = overridingCache.find(store);
+    if (entry != overridingCache.end()) {
+        return entry->second;
+    }
+
+    /* the store must be reachable from the call site of some target */
+    bool isReachable = false;
+    for (RefSetMap::iterator i = refStoresMap.begin(); i != refStoresMap.end(); i++) {
+        InstructionSet &stores = i->second;
+        if (stores.find(store) != stores.end()) {
+            isReachable = true;
+            break;
+        }
+    }
+
+    bool result = false;
+    if (isReachable) {
+        PointsTo pts;
+        getModifiedPts(store, pts);
+        result = modRefPts.intersects(pts);
+    }
+
+    if (result) {
+        overridingStores.insert(store);
+    }
+
+    overridingCache[store] = result;
+    return result;
+}
+
+void ModRefAnalysis::resetQueries() {
+    clearStores(loadToStoreMap);
+    loadToModInfoMap.clear();
+    queriedLoads.clear();
+    overridingStores.clear();
+    overridingCache.clear();
+}
+
+void ModRefAnalysis::computeModInfoToStoreMap() {
+    for (vector<Function *>::iterator i = targetFunctions.begin(); i != targetFunctions.end(); i++) {
+        Function *f = *i;
+        computeModInfoToStoreMap(f);
+    }
+}
+
+void ModRefAnalysis::computeModInfoToStoreMap(Function *f) {
+    InstructionSetRef modSet = pool.getEmpty();
+    ModSetMap::iterator entry = modSetMap.find(f);
+    if (entry != modSetMap.end()) {
+        modSet = entry->second;
+    }
+
+    /* the store sets of the target (interned when done) */
+    map<ModInfo, InstructionSet> modInfoStores;
+
+    uint32_t retSliceId = nextSliceId++;
+    if (hasReturnValue(f)) {
+        retSliceIdMap[f] = retSliceId;
+        SideEffect sideEffect = {
+            .type = ReturnValue,
+            .id = retSliceId,
+            .info = {
+                .f = f
+            },
+            .callSite = NULL
+        };
+        sideEffects.push_back(sideEffect);
+    }
+
+    if (callSiteMode) {
+        /* the modifiers are computed per call site */
+        computeCallSiteModInfoToStoreMap(f);
+        return;
+    }
+
+    for (InstructionSet::const_iterator i = modSet->begin(); i != modSet->end(); i++) {
+        Instruction *store = *i;
+
+        /* the modified allocation sites */
+        set<AllocSite> allocSites;
+        getModifiedAllocSites(f, store, allocSites);
+
+        for (set<AllocSite>::iterator ai = allocSites.begin(); ai != allocSites.end(); ai++) {
+            /* update store instructions */
+            ModInfo modInfo = make_pair(f, *ai);
+            modInfoStores[modInfo].insert(store);
+
+            if (modInfoToIdMap.find(modInfo) == modInfoToIdMap.end()) {
+                uint32_t modSliceId = nextSliceId++;
+                modInfoToIdMap[modInfo] = modSliceId;
+                SideEffect sideEffect = {
+                    .type = Modifier,
+                    .id = modSliceId,
+                    .info = {
+                        .modInfo = modInfo
+                    },
+                    .callSite = NULL
+                };
+                sideEffects.push_back(sideEffect);
+            }
+        }
+    }
+
+    for (map<ModInfo, InstructionSet>::iterator i = modInfoStores.begin(); i != modInfoStores.end(); i++) {
+        setStores(modInfoToStoreMap[i->first], pool.intern(i->second));
+    }
+}
+
+void ModRefAnalysis::computeCallSiteModInfoToStoreMap(Function *f) {
+    vector<Instruction *> &callSites = callSitesMap[f];
+
+    for (vector<Instruction *>::iterator i = callSites.begin(); i != callSites.end(); i++) {
+        Instruction *callSite = *i;
+
+        CallSiteModSetMap::iterator entry = callSiteModSetMap.find(callSite);
+        if (entry == callSiteModSetMap.end()) {
+            continue;
+        }
+
+        const InstructionSet &modSet = *entry->second;
+        map<CallSiteModInfo, InstructionSet> modInfoStores;
+
+        for (InstructionSet::const_iterator j = modSet.begin(); j != modSet.end(); j++) {
+            Instruction *store = *j;
+
+            set<AllocSite> allocSites;
+            getModifiedAllocSites(f, store, allocSites);
+
+            for (set<AllocSite>::iterator ai = allocSites.begin(); ai != allocSites.end(); ai++) {
+                ModInfo modInfo = make_pair(f, *ai);
+                CallSiteModInfo callSiteModInfo = make_pair(callSite, modInfo);
+                modInfoStores[callSiteModInfo].insert(store);
+
+                if (callSiteModInfoToIdMap.find(callSiteModInfo) == callSiteModInfoToIdMap.end()) {
+                    uint32_t modSliceId = nextSliceId++;
+                    callSiteModInfoToIdMap[callSiteModInfo] = modSliceId;
                     SideEffect sideEffect = {
                         .type = Modifier,
                         .id = modSliceId,
                         .info = {
                             .modInfo = modInfo
-                        }
+                        },
+                        .callSite = callSite
                     };
                     sideEffects.push_back(sideEffect);
                 }
             }
         }
+
+        for (map<CallSiteModInfo, InstructionSet>::iterator j = modInfoStores.begin(); j != modInfoStores.end(); j++) {
+            setStores(callSiteModInfoToStoreMap[j->first], pool.intern(j->second));
+        }
+    }
+}
+
+void ModRefAnalysis::getModifiedAllocSites(Function *f, Instruction *store, set<AllocSite> &result) {
+    if (isSummarizedStore(store)) {
+        /* don't expand a large points-to set */
+        result.insert(getUnknownAllocSite());
+        return;
+    }
+
+    PointsTo pts;
+    getModifiedPts(store, pts);
+
+    /* the read-only and the ignored stack objects were filtered by addStore */
+    ModPtsMap::iterator entry = modPtsMap.find(f);
+    if (entry == modPtsMap.end()) {
+        return;
+    }
+    pts &= entry->second;
+
+    for (PointsTo::iterator i = pts.begin(); i != pts.end(); ++i) {
+        result.insert(getAllocSite(*i));
+    }
+}
+
+void ModRefAnalysis::buildSVFG() {
+    svfgBuilder = new SVFGBuilder();
+    svfg = svfgBuilder->buildSVFG(aa->getPTA());
+}
+
+/* follow the indirect (memory) def-use chains of the object from the stores of the target */
+ModRefAnalysis::InstructionSet &ModRefAnalysis::getObservingLoads(Function *f, NodeID nodeId) {
+    pair<Function *, NodeID> k = make_pair(f, nodeId);
+
+    ObjToLoadMap::iterator entry = observingLoadsMap.find(k);
+    if (entry != observingLoadsMap.end()) {
+        return entry->second;
+    }
+
+    InstructionSet &result = observingLoadsMap[k];
+    stack<const SVFGNode *> stack;
+    set<const SVFGNode *> visited;
+    PAG *pag = aa->getPTA()->getPAG();
+
+    InstructionSetRef stores = getStores(f, nodeId);
+    for (InstructionSet::const_iterator i = stores->begin(); i != stores->end(); i++) {
+        Instruction *store = *i;
+
+        PAG::PAGEdgeList &edges = pag->getInstPAGEdgeList(store);
+        for (PAG::PAGEdgeList::iterator j = edges.begin(); j != edges.end(); j++) {
+            PAGEdge *edge = *j;
+            if (!isa<StorePE>(edge)) {
+                continue;
+            }
+
+            const SVFGNode *node = svfg->getStmtVFGNode(edge);
+            stack.push(node);
+            visited.insert(node);
+        }
+    }
+
+    while (!stack.empty()) {
+        const SVFGNode *node = stack.top();
+        stack.pop();
+
+        for (SVFGNode::const_iterator i = node->OutEdgeBegin(); i != node->OutEdgeEnd(); ++i) {
+            const SVFGEdge *edge = *i;
+            if (!edge->isIndirectVFGEdge()) {
+                continue;
+            }
+
+            /* follow only the flows of the given object */
+            const IndirectSVFGEdge *indirectEdge = dyn_cast<IndirectSVFGEdge>(edge);
+            if (!indirectEdge->getPointsTo().test(nodeId)) {
+                continue;
+            }
+
+            const SVFGNode *dst = edge->getDstNode();
+            if (visited.find(dst) != visited.end()) {
+                continue;
+            }
+
+            const LoadSVFGNode *loadNode = dyn_cast<LoadSVFGNode>(dst);
+            if (loadNode) {
+                result.insert((Instruction *)(loadNode->getInst()));
+            }
+
+            stack.push(dst);
+            visited.insert(dst);
+        }
+    }
+
+    return result;
+}
+
+bool ModRefAnalysis::hasObservingLoad(Function *f, NodeID nodeId) {
+    if (hasSummarizedAccess(f, nodeId)) {
+        return true;
+    }
+
+    InstructionSet &observing = getObservingLoads(f, nodeId);
+
+    /* the candidates are the loads found after the call sites */
+    InstructionSet *loads = NULL;
+    if (lazyMode) {
+        loads = &refLoadsMap[f];
+    } else {
+        loads = &objToLoadMap[make_pair(f, nodeId)];
+    }
+
+    for (InstructionSet::iterator i = loads->begin(); i != loads->end(); i++) {
+        if (observing.find(*i) != observing.end()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ModRefAnalysis::isObservedBy(Function *f, NodeID nodeId, Instruction *load) {
+    if (!isa<LoadInst>(load) || hasSummarizedAccess(f, nodeId)) {
+        return true;
+    }
+
+    InstructionSet &observing = getObservingLoads(f, nodeId);
+    return observing.find(load) != observing.end();
+}
+
+/* the memory flows of the library summaries are not modeled in the SVFG */
+bool ModRefAnalysis::hasSummarizedAccess(Function *f, NodeID nodeId) {
+    InstructionSetRef stores = getStores(f, nodeId);
+    for (InstructionSet::const_iterator i = stores->begin(); i != stores->end(); i++) {
+        if (!isa<StoreInst>(*i)) {
+            return true;
+        }
+    }
+
+    /* the candidate loads */
+    InstructionSet *loads = NULL;
+    if (lazyMode) {
+        loads = &refLoadsMap[f];
+    } else {
+        loads = &objToLoadMap[make_pair(f, nodeId)];
+    }
+
+    for (InstructionSet::iterator i = loads->begin(); i != loads->end(); i++) {
+        if (!isa<LoadInst>(*i)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ModRefAnalysis::isSummarizedStore(Instruction *store) {
+    if (ptsLimit == 0) {
+        return false;
+    }
+
+    PointsTo pts;
+    getModifiedPts(store, pts);
+    return pts.count() > ptsLimit;
+}
+
+/* the stores of the target which modify the object */
+ModRefAnalysis::InstructionSetRef ModRefAnalysis::getStores(Function *f, NodeID nodeId) {
+    ObjToStoreMap::iterator entry = objToStoreMap.find(make_pair(f, nodeId));
+    if (entry == objToStoreMap.end()) {
+        return pool.getEmpty();
+    }
+
+    return entry->second;
+}
+
+void ModRefAnalysis::setStores(InstructionSetRef &slot, InstructionSetRef stores) {
+    /* the new handle may be the same set */
+    pool.release(slot);
+    slot = stores;
+}
+
+/* the side effects of the target on the object (the stores which modify it are given) */
+void ModRefAnalysis::getModInfos(Function *f, NodeID nodeId, InstructionSetRef stores, set<ModInfo> &result) {
+    bool hasSummarized = false;
+    bool hasExpanded = false;
+
+    for (InstructionSet::const_iterator i = stores->begin(); i != stores->end(); i++) {
+        if (isSummarizedStore(*i)) {
+            hasSummarized = true;
+        } else {
+            hasExpanded = true;
+        }
+    }
+
+    if (hasExpanded) {
+        result.insert(make_pair(f, getAllocSite(nodeId)));
+    }
+    if (hasSummarized) {
+        result.insert(make_pair(f, getUnknownAllocSite()));
     }
 }
 
@@ -391,6 +1254,44 @@ bool ModRefAnalysis::hasReturnValue(Function *f) {
     return !f->getReturnType()->isVoidTy();
 }
 
+bool ModRefAnalysis::modifiesMemory(Instruction *inst) {
+    return inst->getOpcode() == Instruction::Store || LibrarySummaries::isModifier(inst);
+}
+
+bool ModRefAnalysis::readsMemory(Instruction *inst) {
+    return inst->getOpcode() == Instruction::Load || LibrarySummaries::isReader(inst);
+}
+
+/* the objects which may be modified by a store (or a summarized call) */
+void ModRefAnalysis::getModifiedPts(Instruction *inst, PointsTo &result) {
+    vector<Value *> pointers;
+    if (inst->getOpcode() == Instruction::Store) {
+        pointers.push_back(dyn_cast<StoreInst>(inst)->getPointerOperand());
+    } else {
+        LibrarySummaries::getModifiedPointers(inst, pointers);
+    }
+
+    for (vector<Value *>::iterator i = pointers.begin(); i != pointers.end(); i++) {
+        NodeID id = aa->getPTA()->getPAG()->getValueNode(*i);
+        result |= aa->getPTA()->getPts(id);
+    }
+}
+
+/* the objects which may be read by a load (or a summarized call) */
+void ModRefAnalysis::getReferencedPts(Instruction *inst, PointsTo &result) {
+    vector<Value *> pointers;
+    if (inst->getOpcode() == Instruction::Load) {
+        pointers.push_back(dyn_cast<LoadInst>(inst)->getPointerOperand());
+    } else {
+        LibrarySummaries::getReadPointers(inst, pointers);
+    }
+
+    for (vector<Value *>::iterator i = pointers.begin(); i != pointers.end(); i++) {
+        NodeID id = aa->getPTA()->getPAG()->getValueNode(*i);
+        result |= aa->getPTA()->getPts(id);
+    }
+}
+
 AliasAnalysis::Location ModRefAnalysis::getLoadLocation(LoadInst *inst) {
     Value *addr = inst->getPointerOperand();
     return AliasAnalysis::Location(addr);
@@ -403,7 +1304,11 @@ AliasAnalysis::Location ModRefAnalysis::getStoreLocation(StoreInst *inst) {
 
 /* TODO: validate that a load can't have two ModInfo's with the same allocation site */
 void ModRefAnalysis::getApproximateModInfos(Instruction *inst, AllocSite hint, set<ModInfo> &result) {
-    assert(inst->getOpcode() == Instruction::Load);
+    assert(readsMemory(inst));
+
+    if (lazyMode) {
+        computeLoadInfo(inst);
+    }
 
     LoadToModInfoMap::iterator entry = loadToModInfoMap.find(inst);
     if (entry == loadToModInfoMap.end()) {
@@ -417,8 +1322,8 @@ void ModRefAnalysis::getApproximateModInfos(Instruction *inst, AllocSite hint, s
         ModInfo modInfo = *i;
         AllocSite allocSite = modInfo.second;
 
-        /* compare only the allocation sites (values) */
-        if (allocSite.first == hint.first) {
+        /* compare only the allocation sites (values), the summary may modify any object */
+        if (allocSite.first == hint.first || allocSite == getUnknownAllocSite()) {
             result.insert(modInfo);
         }
     }
@@ -426,14 +1331,43 @@ void ModRefAnalysis::getApproximateModInfos(Instruction *inst, AllocSite hint, s
     return;
 }
 
+void ModRefAnalysis::getApproximateModInfos(
+    Instruction *callSite,
+    Instruction *inst,
+    AllocSite hint,
+    set<CallSiteModInfo> &result
+) {
+    assert(readsMemory(inst));
+
+    LoadToCallSiteModInfoMap::iterator entry = loadToCallSiteModInfoMap.find(inst);
+    if (entry == loadToCallSiteModInfoMap.end()) {
+        /* the load is not affected by any call site */
+        return;
+    }
+
+    set<CallSiteModInfo> &modifiers = entry->second;
+
+    for (set<CallSiteModInfo>::iterator i = modifiers.begin(); i != modifiers.end(); i++) {
+        const CallSiteModInfo &callSiteModInfo = *i;
+        if (callSiteModInfo.first != callSite) {
+            continue;
+        }
+
+        AllocSite allocSite = callSiteModInfo.second.second;
+        if (allocSite.first == hint.first || allocSite == getUnknownAllocSite()) {
+            result.insert(callSiteModInfo);
+        }
+    }
+}
+
 void ModRefAnalysis::dumpModSetMap() {
     debugs << "### ModSetMap ###\n";
 
     for (ModSetMap::iterator i = modSetMap.begin(); i != modSetMap.end(); i++) {
         Function *f = i->first;
-        InstructionSet &modSet = i->second;
+        const InstructionSet &modSet = *i->second;
 
-        for (InstructionSet::iterator j = modSet.begin(); j != modSet.end(); j++) {
+        for (InstructionSet::const_iterator j = modSet.begin(); j != modSet.end(); j++) {
             Instruction *inst = *j;
             dumpInst(inst);
         }
@@ -446,10 +1380,10 @@ void ModRefAnalysis::dumpLoadToStoreMap() {
 
     for (LoadToStoreMap::iterator i = loadToStoreMap.begin(); i != loadToStoreMap.end(); i++) {
         Instruction *load = i->first;
-        InstructionSet &stores = i->second;
+        const InstructionSet &stores = *i->second;
 
         dumpInst(load);
-        for (InstructionSet::iterator j = stores.begin(); j != stores.end(); j++) {
+        for (InstructionSet::const_iterator j = stores.begin(); j != stores.end(); j++) {
             Instruction *store = *j;
 
             dumpInst(store, "\t");
@@ -479,10 +1413,10 @@ void ModRefAnalysis::dumpModInfoToStoreMap() {
 
     for (ModInfoToStoreMap::iterator i = modInfoToStoreMap.begin(); i != modInfoToStoreMap.end(); i++) {
         const ModInfo &modInfo = i->first;
-        InstructionSet &stores = i->second;
+        const InstructionSet &stores = *i->second;
 
         dumpModInfo(modInfo);
-        for (InstructionSet::iterator j = stores.begin(); j != stores.end(); j++) {
+        for (InstructionSet::const_iterator j = stores.begin(); j != stores.end(); j++) {
             Instruction *store = *j;
             dumpInst(store, "\t");
         }
@@ -503,6 +1437,22 @@ void ModRefAnalysis::dumpModInfoToIdMap() {
     debugs << "\n";
 }
 
+void ModRefAnalysis::dumpLoadToCallSiteModInfoMap() {
+    debugs << "### LoadToCallSiteModInfoMap ###\n";
+
+    for (LoadToCallSiteModInfoMap::iterator i = loadToCallSiteModInfoMap.begin(); i != loadToCallSiteModInfoMap.end(); i++) {
+        Instruction *load = i->first;
+        set<CallSiteModInfo> &modInfos = i->second;
+
+        dumpInst(load);
+        for (set<CallSiteModInfo>::iterator j = modInfos.begin(); j != modInfos.end(); j++) {
+            dumpInst(j->first, "\t");
+            dumpModInfo(j->second, "\t");
+        }
+    }
+    debugs << "\n";
+}
+
 void ModRefAnalysis::dumpOverridingStores() {
     debugs << "### Overriding Stores ###\n";
 
@@ -513,6 +1463,145 @@ void ModRefAnalysis::dumpOverridingStores() {
     debugs << "\n";
 }
 
+void ModRefAnalysis::dumpStatistics(unsigned int limit) {
+    debugs << "### Statistics ###\n";
+
+    /* points-to set sizes of the modifying stores and the referencing loads */
+    InstructionSet stores;
+    for (ModSetMap::iterator i = modSetMap.begin(); i != modSetMap.end(); i++) {
+        stores.insert(i->second->begin(), i->second->end());
+    }
+
+    InstructionSet loads;
+    for (ObjToLoadMap::iterator i = objToLoadMap.begin(); i != objToLoadMap.end(); i++) {
+        loads.insert(i->second.begin(), i->second.end());
+    }
+    for (RefSetMap::iterator i = refLoadsMap.begin(); i != refLoadsMap.end(); i++) {
+        loads.insert(i->second.begin(), i->second.end());
+    }
+
+    dumpHistogram("stores", stores, true);
+    dumpHistogram("loads", loads, false);
+
+    /* allocation sites with the most ModInfo's (in call-site mode, counted per call site) */
+    map<const Value *, uint32_t> allocSiteCount;
+    if (callSiteMode) {
+        for (CallSiteModInfoToIdMap::iterator i = callSiteModInfoToIdMap.begin(); i != callSiteModInfoToIdMap.end(); i++) {
+            const ModInfo &modInfo = i->first.second;
+            allocSiteCount[modInfo.second.first]++;
+        }
+    } else {
+        for (ModInfoToIdMap::iterator i = modInfoToIdMap.begin(); i != modInfoToIdMap.end(); i++) {
+            const ModInfo &modInfo = i->first;
+            allocSiteCount[modInfo.second.first]++;
+        }
+    }
+
+    vector<pair<uint32_t, const Value *> > allocSites;
+    for (map<const Value *, uint32_t>::iterator i = allocSiteCount.begin(); i != allocSiteCount.end(); i++) {
+        allocSites.push_back(make_pair(i->second, i->first));
+    }
+    sort(allocSites.rbegin(), allocSites.rend());
+
+    debugs << "allocation sites (by ModInfo's):\n";
+    for (unsigned int i = 0; i < allocSites.size() && i < limit; i++) {
+        debugs << "\t" << allocSites[i].first << ":";
+        if (allocSites[i].second) {
+            allocSites[i].second->print(debugs);
+        } else {
+            debugs << " unknown";
+        }
+        debugs << "\n";
+    }
+
+    /* stores which contribute to the most side effects */
+    map<Instruction *, uint32_t> storeCount;
+    if (callSiteMode) {
+        for (CallSiteModInfoToStoreMap::iterator i = callSiteModInfoToStoreMap.begin(); i != callSiteModInfoToStoreMap.end(); i++) {
+            const InstructionSet &modStores = *i->second;
+            for (InstructionSet::const_iterator j = modStores.begin(); j != modStores.end(); j++) {
+                storeCount[*j]++;
+            }
+        }
+    } else {
+        for (ModInfoToStoreMap::iterator i = modInfoToStoreMap.begin(); i != modInfoToStoreMap.end(); i++) {
+            const InstructionSet &modStores = *i->second;
+            for (InstructionSet::const_iterator j = modStores.begin(); j != modStores.end(); j++) {
+                storeCount[*j]++;
+            }
+        }
+    }
+
+    vector<pair<uint32_t, Instruction *> > topStores;
+    for (map<Instruction *, uint32_t>::iterator i = storeCount.begin(); i != storeCount.end(); i++) {
+        topStores.push_back(make_pair(i->second, i->first));
+    }
+    sort(topStores.rbegin(), topStores.rend());
+
+    debugs << "stores (by side effects):\n";
+    for (unsigned int i = 0; i < topStores.size() && i < limit; i++) {
+        debugs << "\t" << topStores[i].first << ":";
+        dumpInst(topStores[i].second);
+    }
+
+    /* each slice clones all the (defined) functions which are reachable from the target */
+    map<Function *, uint32_t> sideEffectCount;
+    for (SideEffects::iterator i = sideEffects.begin(); i != sideEffects.end(); i++) {
+        sideEffectCount[i->getFunction()]++;
+    }
+
+    debugs << "estimated clones:\n";
+    for (vector<Function *>::iterator i = targetFunctions.begin(); i != targetFunctions.end(); i++) {
+        Function *f = *i;
+
+        uint32_t defined = 0;
+        set<Function *> &reachable = ra->getReachableFunctions(f);
+        for (set<Function *>::iterator j = reachable.begin(); j != reachable.end(); j++) {
+            if (!(*j)->isDeclaration()) {
+                defined++;
+            }
+        }
+
+        uint32_t count = sideEffectCount[f];
+        debugs << "\t" << f->getName() << ": " << count << " slices, " << count * defined << " clones\n";
+    }
+
+    debugs << "\n";
+}
+
+/* histogram of the points-to set sizes (the buckets are powers of two) */
+void ModRefAnalysis::dumpHistogram(const char *title, InstructionSet &insts, bool modifies) {
+    map<uint32_t, uint32_t> histogram;
+
+    for (InstructionSet::iterator i = insts.begin(); i != insts.end(); i++) {
+        Instruction *inst = *i;
+
+        PointsTo pts;
+        if (modifies) {
+            getModifiedPts(inst, pts);
+        } else {
+            getReferencedPts(inst, pts);
+        }
+        uint32_t size = pts.count();
+
+        uint32_t bucket = 0;
+        while ((1U << bucket) <= size) {
+            bucket++;
+        }
+        histogram[bucket]++;
+    }
+
+    debugs << "points-to sizes (" << title << "):\n";
+    for (map<uint32_t, uint32_t>::iterator i = histogram.begin(); i != histogram.end(); i++) {
+        uint32_t bucket = i->first;
+        if (bucket == 0) {
+            debugs << "\t0: " << i->second << "\n";
+        } else {
+            debugs << "\t" << (1U << (bucket - 1)) << "-" << (1U << bucket) - 1 << ": " << i->second << "\n";
+        }
+    }
+}
+
 void ModRefAnalysis::dumpInst(Instruction *inst, const char *prefix) {
     Function *f = inst->getParent()->getParent();
 
@@ -529,6 +1618,10 @@ void ModRefAnalysis::dumpModInfo(const ModInfo &modInfo, const char *prefix) {
     uint64_t offset = allocSite.second;
 
     debugs << prefix << "function: " << f->getName() << "\n";
-    debugs << prefix << "allocation site: "; value->print(debugs); debugs << "\n";
+    if (value) {
+        debugs << prefix << "allocation site: "; value->print(debugs); debugs << "\n";
+    } else {
+        debugs << prefix << "allocation site: unknown\n";
+    }
     debugs << prefix << "offset: " << offset << "\n";
 }
@@ -14,31 +14,45 @@
 
 #include "ReachabilityAnalysis.h"
 #include "AAPass.h"
+#include "InstructionSetPool.h"
+#include "EscapeAnalysis.h"
+
+class SVFG;
+class SVFGBuilder;
 
 class ModRefAnalysis {
 public:
 
     typedef std::set<llvm::Instruction *> InstructionSet;
+    /* immutable instruction sets are shared (see InstructionSetPool) */
+    typedef InstructionSetPool::InstructionSetRef InstructionSetRef;
 
     typedef std::map<llvm::Function *, PointsTo> ModPtsMap;
-    typedef std::map<llvm::Function *, InstructionSet> ModSetMap;
+    typedef std::map<llvm::Function *, InstructionSetRef> ModSetMap;
 
     typedef std::map<llvm::Function *, PointsTo> RefPtsMap;
+    typedef std::map<llvm::Function *, InstructionSet> RefSetMap;
 
-    typedef std::map<std::pair<llvm::Function *, NodeID>, InstructionSet> ObjToStoreMap;
+    typedef std::map<std::pair<llvm::Function *, NodeID>, InstructionSetRef> ObjToStoreMap;
     typedef std::map<std::pair<llvm::Function *, NodeID>, InstructionSet> ObjToLoadMap;
-    typedef std::map<NodeID, InstructionSet> ObjToOverridingStoreMap;
-    typedef std::map<llvm::Instruction *, InstructionSet> LoadToStoreMap;
+    typedef std::map<std::pair<llvm::Function *, NodeID>, InstructionSet> ObjToOverridingStoreMap;
+    typedef std::map<llvm::Instruction *, InstructionSetRef> LoadToStoreMap;
 
     typedef std::pair<const llvm::Value *, uint64_t> AllocSite;
     typedef std::pair<llvm::Function *, AllocSite> ModInfo;
 
     typedef std::map<llvm::Instruction *, std::set<ModInfo> > LoadToModInfoMap;
-    typedef std::map<ModInfo, InstructionSet> ModInfoToStoreMap;
+    typedef std::map<ModInfo, InstructionSetRef> ModInfoToStoreMap;
     typedef std::map<ModInfo, uint32_t> ModInfoToIdMap;
     typedef std::map<uint32_t, ModInfo> IdToModInfoMap;
     typedef std::map<llvm::Function *, uint32_t> RetSliceIdMap;
 
+    /* a side effect of a target with respect to one of its call sites */
+    typedef std::pair<llvm::Instruction *, ModInfo> CallSiteModInfo;
+    typedef std::map<llvm::Instruction *, std::set<CallSiteModInfo> > LoadToCallSiteModInfoMap;
+    typedef std::map<CallSiteModInfo, InstructionSetRef> CallSiteModInfoToStoreMap;
+    typedef std::map<CallSiteModInfo, uint32_t> CallSiteModInfoToIdMap;
+
     typedef enum {
         Modifier,
         ReturnValue,
@@ -51,6 +65,8 @@ public:
             ModInfo modInfo;
             llvm::Function *f;
         } info;
+        /* the call site of a modifier (call-site mode only) */
+        llvm::Instruction *callSite;
 
         llvm::Function *getFunction() {
             if (type == Modifier) {
@@ -66,14 +82,67 @@ public:
 
     typedef std::vector<SideEffect> SideEffects;
 
+    ModRefAnalysis(
+        llvm::Module *module,
+        ReachabilityAnalysis *ra,
+        AAPass *aa,
+        llvm::Function *entry,
+        std::vector<llvm::Function *> targets,
+        llvm::raw_ostream &debugs,
+        bool lazyMode = false
+    );
+
     ModRefAnalysis(
         llvm::Module *module,
         ReachabilityAnalysis *ra,
         AAPass *aa,
         std::string entry,
         std::vector<std::string> targets,
-        llvm::raw_ostream &debugs
-    );
+        llvm::raw_ostream &debugs,
+        bool lazyMode = false
+    ) :
+        ModRefAnalysis(
+            module,
+            ra,
+            aa,
+            (llvm::Function *)(NULL),
+            std::vector<llvm::Function *>(),
+            debugs,
+            lazyMode
+        )
+    {
+        /* the names are resolved by run() */
+        entryName = entry;
+        targetNames = targets;
+        isResolved = false;
+    }
+
+    ~ModRefAnalysis();
+
+    /* use the def-use chains of the SVFG (memory SSA) to filter the side effects */
+    void setSVFGMode(bool enabled) {
+        svfgMode = enabled;
+    }
+
+    /* compute the side effects (and slices) per call site of a target, eager mode only */
+    void setCallSiteMode(bool enabled) {
+        callSiteMode = enabled;
+    }
+
+    /* report the statistics of the side effects (to the debug stream) after run() */
+    void setStatisticsMode(bool enabled) {
+        statisticsMode = enabled;
+    }
+
+    /* stores with more than k pointees are summarized by a single side effect (0 = no limit) */
+    void setPtsLimit(uint32_t k) {
+        ptsLimit = k;
+    }
+
+    /* the allocation site of the summary side effect */
+    static AllocSite getUnknownAllocSite() {
+        return AllocSite(NULL, 0);
+    }
 
     llvm::Function *getEntry();
 
@@ -81,6 +150,15 @@ public:
 
     void run();
 
+    /* add a target function without recomputing the other targets (after run) */
+    void addTarget(llvm::Function *f);
+
+    /* remove a target function, the slice id's of the other targets are kept (after run) */
+    void removeTarget(llvm::Function *f);
+
+    /* free the maps which are needed only for computing the results (eager mode only) */
+    void releaseBuildState();
+
     ModInfoToStoreMap &getModInfoToStoreMap();
 
     SideEffects &getSideEffects();
@@ -89,6 +167,10 @@ public:
 
     ModInfoToIdMap &getModInfoToIdMap();
 
+    CallSiteModInfoToStoreMap &getCallSiteModInfoToStoreMap();
+
+    CallSiteModInfoToIdMap &getCallSiteModInfoToIdMap();
+
     bool mayBlock(llvm::Instruction *load);
 
     bool mayOverride(llvm::Instruction *store);
@@ -97,6 +179,14 @@ public:
 
     void getApproximateModInfos(llvm::Instruction *inst, AllocSite hint, std::set<ModInfo> &result);
 
+    /* the side effects of a specific call site which may affect the load (call-site mode) */
+    void getApproximateModInfos(
+        llvm::Instruction *callSite,
+        llvm::Instruction *inst,
+        AllocSite hint,
+        std::set<CallSiteModInfo> &result
+    );
+
     void dumpModSetMap();
 
     void dumpLoadToStoreMap();
@@ -107,8 +197,13 @@ public:
 
     void dumpModInfoToIdMap();
 
+    void dumpLoadToCallSiteModInfoMap();
+
     void dumpOverridingStores();
 
+    /* report the sources of side effects (and slices) */
+    void dumpStatistics(unsigned int limit = 10);
+
     void dumpInst(llvm::Instruction *load, const char *prefix = "");
     
     void dumpModInfo(const ModInfo &modInfo, const char *prefix = "");
@@ -116,31 +211,103 @@ public:
 private:
 
     typedef std::map<llvm::Function *, bool> ReachabilityCache;
+    typedef std::map<llvm::Instruction *, bool> OverridingCache;
+    typedef std::map<NodeID, InstructionSet> ObjToStoreSetMap;
+    typedef std::map<llvm::Instruction *, std::set<InstructionSetRef> > LoadToStoreRefsMap;
+    typedef std::map<llvm::Function *, std::vector<llvm::Instruction *> > CallSitesMap;
+    typedef std::map<llvm::Instruction *, PointsTo> CallSiteRefPtsMap;
+    typedef std::map<std::pair<llvm::Instruction *, NodeID>, InstructionSet> CallSiteObjToLoadMap;
+    typedef std::map<llvm::Instruction *, InstructionSetRef> CallSiteModSetMap;
 
     /* priate methods */
 
+    void resolveFunctions();
+
     void computeMod(llvm::Function *entry, llvm::Function *f);
 
     void collectModInfo(llvm::Function *f);
 
-    void addStore(llvm::Function *f, llvm::Instruction *store);
+    void addStore(llvm::Function *f, llvm::Instruction *store, ObjToStoreSetMap &objStores);
 
     bool canIgnoreStackObject(llvm::Function *f, const llvm::Value *value);
 
+    bool isReadOnlyObject(const llvm::Value *value);
+
     void collectRefInfo(llvm::Function *entry);
 
     void addLoad(llvm::Function *f, llvm::Instruction *load);
 
-    void addOverridingStore(llvm::Instruction *store);
+    void collectCallSiteRefInfo(llvm::Instruction *callSite);
+
+    void addOverridingStore(llvm::Function *f, llvm::Instruction *store);
 
     void computeModRefInfo();
 
+    void computeModRefInfo(llvm::Function *f);
+
+    void computeCallSiteModRefInfo(llvm::Function *f);
+
+    void computeOverridingStores();
+
     void computeModInfoToStoreMap();
 
+    void computeModInfoToStoreMap(llvm::Function *f);
+
+    void computeCallSiteModInfoToStoreMap(llvm::Function *f);
+
+    void getModifiedAllocSites(llvm::Function *f, llvm::Instruction *store, std::set<AllocSite> &result);
+
+    void removeCallSites(llvm::Function *f);
+
+    void updateLoadInfo(llvm::Instruction *load);
+
+    void computeLoadInfo(llvm::Instruction *load);
+
+    void dumpHistogram(const char *title, InstructionSet &insts, bool modifies);
+
+    void buildSVFG();
+
+    InstructionSet &getObservingLoads(llvm::Function *f, NodeID nodeId);
+
+    bool hasObservingLoad(llvm::Function *f, NodeID nodeId);
+
+    bool isObservedBy(llvm::Function *f, NodeID nodeId, llvm::Instruction *load);
+
+    bool computeMayOverride(llvm::Instruction *store);
+
+    void resetQueries();
+
+    bool hasSummarizedAccess(llvm::Function *f, NodeID nodeId);
+
+    bool isSummarizedStore(llvm::Instruction *store);
+
+    void getModInfos(llvm::Function *f, NodeID nodeId, InstructionSetRef stores, std::set<ModInfo> &result);
+
+    InstructionSetRef getStores(llvm::Function *f, NodeID nodeId);
+
+    /* replace a pooled handle (the previous one is released) */
+    void setStores(InstructionSetRef &slot, InstructionSetRef stores);
+
+    template <typename T>
+    void clearStores(T &m) {
+        for (typename T::iterator i = m.begin(); i != m.end(); i++) {
+            pool.release(i->second);
+        }
+        m.clear();
+    }
+
     AllocSite getAllocSite(NodeID);
 
     bool hasReturnValue(llvm::Function *f);
 
+    bool modifiesMemory(llvm::Instruction *inst);
+
+    bool readsMemory(llvm::Instruction *inst);
+
+    void getModifiedPts(llvm::Instruction *inst, PointsTo &result);
+
+    void getReferencedPts(llvm::Instruction *inst, PointsTo &result);
+
     llvm::AliasAnalysis::Location getLoadLocation(llvm::LoadInst *inst);
 
     llvm::AliasAnalysis::Location getStoreLocation(llvm::StoreInst *inst);
@@ -151,8 +318,10 @@ private:
     ReachabilityAnalysis *ra;
     AAPass *aa;
 
-    std::string entry;
-    std::vector<std::string> targets;
+    /* used for diagnostics, and for resolving the functions if they were passed by name */
+    std::string entryName;
+    std::vector<std::string> targetNames;
+    bool isResolved;
     llvm::Function *entryFunction;
     std::vector<llvm::Function *> targetFunctions;
 
@@ -164,6 +333,9 @@ private:
 
     ModSetMap modSetMap;
 
+    /* holds the instruction sets which are shared by the maps */
+    InstructionSetPool pool;
+
     /* TODO: no need to hold the store instructions */
     LoadToStoreMap loadToStoreMap;
 
@@ -172,6 +344,8 @@ private:
 
     ModInfoToIdMap modInfoToIdMap;
     RetSliceIdMap retSliceIdMap;
+    /* slice id's are never reused, so existing slices remain valid */
+    uint32_t nextSliceId;
 
     SideEffects sideEffects;
 
@@ -179,7 +353,45 @@ private:
 
     ReachabilityCache cache;
 
+    EscapeAnalysis escapeAnalysis;
+
     llvm::raw_ostream &debugs;
+
+    /* in lazy mode, the per-load information is computed on demand */
+    bool lazyMode;
+    /* the loads and stores found after the call sites of each target */
+    RefSetMap refLoadsMap;
+    RefSetMap refStoresMap;
+    /* the union of the modified and referenced objects of all the targets */
+    PointsTo modRefPts;
+    InstructionSet queriedLoads;
+    OverridingCache overridingCache;
+
+    bool svfgMode;
+    SVFGBuilder *svfgBuilder;
+    SVFG *svfg;
+    /* the loads which are reachable in the SVFG from the stores of a target to an object */
+    ObjToLoadMap observingLoadsMap;
+
+    uint32_t ptsLimit;
+
+    bool callSiteMode;
+    /* the relevant call sites of each target */
+    CallSitesMap callSitesMap;
+    CallSiteRefPtsMap callSiteRefPtsMap;
+    CallSiteObjToLoadMap callSiteObjToLoadMap;
+    CallSiteModSetMap callSiteModSetMap;
+    LoadToCallSiteModInfoMap loadToCallSiteModInfoMap;
+    CallSiteModInfoToStoreMap callSiteModInfoToStoreMap;
+    CallSiteModInfoToIdMap callSiteModInfoToIdMap;
+
+    bool statisticsMode;
+
+    /* run() was called, so targets can be added or removed */
+    bool isAnalyzed;
+
+    /* targets can't be added or removed once the build state is released */
+    bool isReleased;
 };
 
 #endif
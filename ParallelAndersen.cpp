@@ -0,0 +1,221 @@
+#include <stdbool.h>
+#include <vector>
+#include <map>
+#include <thread>
+#include <chrono>
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <MemoryModel/PAG.h>
+#include <MemoryModel/PointerAnalysis.h>
+#include <MemoryModel/ConsG.h>
+#include <WPA/Andersen.h>
+
+#include "ParallelAndersen.h"
+
+using namespace std;
+using namespace llvm;
+
+/* smaller waves are not worth the thread creation */
+static const size_t MinParallelWave = 256;
+
+ParallelAndersen::ParallelAndersen(unsigned int threads) :
+    AndersenWave(),
+    threads(threads)
+{
+    if (this->threads == 0) {
+        this->threads = thread::hardware_concurrency();
+    }
+    if (this->threads == 0) {
+        this->threads = 1;
+    }
+}
+
+/* the address edges are processed once by Andersen::analyze */
+void ParallelAndersen::solveWorklist() {
+    /* collapse the cycles and get the topological order */
+    NodeStack &nodeStack = SCCDetect();
+
+    Waves waves;
+    computeWaves(nodeStack, waves);
+
+    for (Waves::iterator i = waves.begin(); i != waves.end(); i++) {
+        Wave &wave = *i;
+
+        /* the nodes may be merged by the field collapsing of the previous waves */
+        removeMergedNodes(wave);
+        vector<char> changed(wave.size(), 0);
+
+        /* the points-to sets must exist before the parallel phase (no insertions),
+           including the ones of the representatives which are pulled from */
+        for (Wave::iterator j = wave.begin(); j != wave.end(); j++) {
+            getPts(*j);
+
+            ConstraintNode *node = consCG->getConstraintNode(*j);
+            for (ConstraintNode::const_iterator k = node->directInEdgeBegin(); k != node->directInEdgeEnd(); ++k) {
+                if (isa<CopyCGEdge>(*k)) {
+                    getPts(sccRepNode((*k)->getSrcID()));
+                }
+            }
+        }
+
+        propagateWave(wave, changed);
+
+        /* the gep edges may create new objects, so they are handled serially */
+        for (size_t j = 0; j < wave.size(); j++) {
+            NodeID nodeId = wave[j];
+            if (sccRepNode(nodeId) != nodeId) {
+                /* merged by a previous node of this wave */
+                continue;
+            }
+
+            /* the points-to set of the node is complete for this round */
+            collapsePWCNode(nodeId);
+
+            if (changed[j]) {
+                pushIntoWorklist(nodeId);
+            }
+            processGeps(nodeId);
+
+            collapseFields();
+        }
+    }
+
+    /* process the load and store edges */
+    while (!isWorklistEmpty()) {
+        NodeID nodeId = popFromWorklist();
+        postProcessNode(nodeId);
+    }
+}
+
+/* the wave of a node is after the waves of its direct predecessors */
+void ParallelAndersen::computeWaves(NodeStack &nodeStack, Waves &waves) {
+    map<NodeID, size_t> levels;
+
+    while (!nodeStack.empty()) {
+        NodeID nodeId = nodeStack.top();
+        nodeStack.pop();
+
+        size_t level = 0;
+        ConstraintNode *node = consCG->getConstraintNode(nodeId);
+        for (ConstraintNode::const_iterator i = node->directInEdgeBegin(); i != node->directInEdgeEnd(); ++i) {
+            NodeID src = sccRepNode((*i)->getSrcID());
+            if (src == nodeId) {
+                continue;
+            }
+
+            map<NodeID, size_t>::iterator entry = levels.find(src);
+            if (entry != levels.end() && entry->second + 1 > level) {
+                level = entry->second + 1;
+            }
+        }
+
+        levels[nodeId] = level;
+        if (waves.size() <= level) {
+            waves.resize(level + 1);
+        }
+        waves[level].push_back(nodeId);
+    }
+}
+
+void ParallelAndersen::propagateWave(Wave &wave, vector<char> &changed) {
+    if (threads == 1 || wave.size() < MinParallelWave) {
+        propagateRange(wave, changed, 0, wave.size());
+        return;
+    }
+
+    vector<thread> workers;
+    size_t chunk = (wave.size() + threads - 1) / threads;
+    for (size_t begin = 0; begin < wave.size(); begin += chunk) {
+        size_t end = min(begin + chunk, wave.size());
+        workers.push_back(thread(&ParallelAndersen::propagateRange, this, ref(wave), ref(changed), begin, end));
+    }
+
+    for (vector<thread>::iterator i = workers.begin(); i != workers.end(); i++) {
+        i->join();
+    }
+}
+
+void ParallelAndersen::propagateRange(Wave &wave, vector<char> &changed, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        changed[i] = pullPts(wave[i]);
+    }
+}
+
+/* only the points-to set of the given node is modified */
+bool ParallelAndersen::pullPts(NodeID nodeId) {
+    bool changed = false;
+
+    ConstraintNode *node = consCG->getConstraintNode(nodeId);
+    for (ConstraintNode::const_iterator i = node->directInEdgeBegin(); i != node->directInEdgeEnd(); ++i) {
+        if (!isa<CopyCGEdge>(*i)) {
+            continue;
+        }
+
+        NodeID src = sccRepNode((*i)->getSrcID());
+        if (src == nodeId) {
+            continue;
+        }
+
+        if (unionPts(nodeId, src)) {
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+void ParallelAndersen::removeMergedNodes(Wave &wave) {
+    Wave::iterator last = wave.begin();
+    for (Wave::iterator i = wave.begin(); i != wave.end(); i++) {
+        if (sccRepNode(*i) == *i) {
+            *last++ = *i;
+        }
+    }
+
+    wave.erase(last, wave.end());
+}
+
+void ParallelAndersen::processGeps(NodeID nodeId) {
+    ConstraintNode *node = consCG->getConstraintNode(nodeId);
+    for (ConstraintNode::const_iterator i = node->directOutEdgeBegin(); i != node->directOutEdgeEnd(); ++i) {
+        GepCGEdge *edge = dyn_cast<GepCGEdge>(*i);
+        if (edge) {
+            processGep(nodeId, edge);
+        }
+    }
+}
+
+bool ParallelAndersen::benchmark(Module &module, ParallelAndersen *parallel, raw_ostream &os) {
+    /* both solvers share the PAG, so only the serial one is temporary */
+    AndersenWave *serial = new AndersenWave();
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    serial->analyze(module);
+    chrono::steady_clock::time_point serialEnd = chrono::steady_clock::now();
+    parallel->analyze(module);
+    chrono::steady_clock::time_point parallelEnd = chrono::steady_clock::now();
+
+    /* the results must be identical */
+    uint32_t mismatches = 0;
+    PAG *pag = serial->getPAG();
+    for (PAG::iterator i = pag->begin(); i != pag->end(); ++i) {
+        NodeID id = i->first;
+        if (serial->getPts(id) != parallel->getPts(id)) {
+            mismatches++;
+        }
+    }
+
+    uint64_t serialTime = chrono::duration_cast<chrono::milliseconds>(serialEnd - start).count();
+    uint64_t parallelTime = chrono::duration_cast<chrono::milliseconds>(parallelEnd - serialEnd).count();
+
+    os << "### Andersen Benchmark ###\n";
+    os << "serial: " << serialTime << " ms\n";
+    os << "parallel (" << parallel->getThreads() << " threads): " << parallelTime << " ms\n";
+    os << "mismatches: " << mismatches << "\n";
+
+    delete serial;
+
+    return mismatches == 0;
+}
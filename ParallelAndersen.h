@@ -0,0 +1,63 @@
+#ifndef PARALLELANDERSEN_H
+#define PARALLELANDERSEN_H
+
+#include <stdbool.h>
+#include <vector>
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <MemoryModel/PointerAnalysis.h>
+#include <WPA/Andersen.h>
+
+/*
+ * Wave propagation with a parallel propagation phase.
+ *
+ * The nodes of the (SCC collapsed) constraint graph are split into waves,
+ * such that the copy predecessors of a node are in earlier waves. The nodes
+ * of a wave are processed in parallel, and each node pulls the points-to sets
+ * of its predecessors, so a points-to set is written only by its owner and no
+ * locking is required. The gep edges and the load/store edges may create new
+ * nodes and edges, so they are processed serially (with the cycle and
+ * field collapsing of AndersenWave).
+ */
+class ParallelAndersen : public AndersenWave {
+public:
+
+    typedef std::vector<NodeID> Wave;
+    typedef std::vector<Wave> Waves;
+
+    /* 0 threads means one thread per core */
+    ParallelAndersen(unsigned int threads = 0);
+
+    virtual ~ParallelAndersen() {};
+
+    unsigned int getThreads() {
+        return threads;
+    }
+
+    /* run the serial and the given parallel solver, and compare their results and time */
+    static bool benchmark(llvm::Module &module, ParallelAndersen *parallel, llvm::raw_ostream &os);
+
+protected:
+
+    virtual void solveWorklist();
+
+private:
+
+    void computeWaves(NodeStack &nodeStack, Waves &waves);
+
+    void propagateWave(Wave &wave, std::vector<char> &changed);
+
+    void propagateRange(Wave &wave, std::vector<char> &changed, size_t begin, size_t end);
+
+    bool pullPts(NodeID nodeId);
+
+    void processGeps(NodeID nodeId);
+
+    void removeMergedNodes(Wave &wave);
+
+    unsigned int threads;
+};
+
+#endif /* PARALLELANDERSEN_H */
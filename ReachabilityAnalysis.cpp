@@ -3,6 +3,7 @@
 #include <vector>
 #include <stack>
 #include <set>
+#include <algorithm>
 
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
@@ -14,11 +15,41 @@
 #include <llvm/Support/raw_ostream.h>
 
 #include "AAPass.h"
+#include "LibrarySummaries.h"
 #include "ReachabilityAnalysis.h"
 
 using namespace std;
 using namespace llvm;
 
+vector<Function *> ReachabilityAnalysis::getFunctions(Module *module, const vector<string> &names) {
+    vector<Function *> functions;
+    for (vector<string>::const_iterator i = names.begin(); i != names.end(); i++) {
+        functions.push_back(module->getFunction(*i));
+    }
+
+    return functions;
+}
+
+vector<string> ReachabilityAnalysis::getNames(const vector<Function *> &functions) {
+    vector<string> names;
+    for (vector<Function *>::const_iterator i = functions.begin(); i != functions.end(); i++) {
+        Function *f = *i;
+        names.push_back(f ? f->getName().str() : "");
+    }
+
+    return names;
+}
+
+void ReachabilityAnalysis::resolveFunctions() {
+    if (isResolved) {
+        return;
+    }
+
+    entryFunction = module->getFunction(entryName);
+    targetFunctions = getFunctions(module, targetNames);
+    isResolved = true;
+}
+
 void ReachabilityAnalysis::prepare() {
     /* remove unused functions using fixpoint */
     removeUnusedValues();
@@ -38,7 +69,9 @@ bool ReachabilityAnalysis::removeUnusedValues(bool &changed) {
     std::set<Function *> functions;
     set<string> keep;
 
-    keep.insert(entry);
+    /* the targets may be referenced by handles, so they are kept even if unused */
+    keep.insert(entryName);
+    keep.insert(targetNames.begin(), targetNames.end());
 
     for (Module::iterator i = module->begin(); i != module->end(); i++) {
         Function *f = &*i;
@@ -93,22 +126,21 @@ void ReachabilityAnalysis::computeFunctionTypeMap() {
 bool ReachabilityAnalysis::run(bool usePA) {
     vector<Function *> all;
 
+    resolveFunctions();
+
     /* check parameters... */
-    entryFunction = module->getFunction(entry);
     if (!entryFunction) {
-        errs() << "entry function '" << entry << "' is not found\n";
+        errs() << "entry function '" << entryName << "' is not found\n";
         return false;
     }
     all.push_back(entryFunction);
 
-    for (vector<string>::iterator i = targets.begin(); i != targets.end(); i++) {
-        string name = *i;
-        Function *f = module->getFunction(name);
+    for (unsigned int i = 0; i < targetFunctions.size(); i++) {
+        Function *f = targetFunctions[i];
         if (!f) {
-            errs() << "function '" << name << "' is not found\n";
+            errs() << "function '" << targetNames[i] << "' is not found\n";
             return false;
         }
-        targetFunctions.push_back(f);
         all.push_back(f);
     }
 
@@ -123,6 +155,39 @@ bool ReachabilityAnalysis::run(bool usePA) {
     return true;
 }
 
+void ReachabilityAnalysis::addTarget(Function *f) {
+    assert(!isReleased);
+
+    resolveFunctions();
+
+    if (find(targetFunctions.begin(), targetFunctions.end(), f) == targetFunctions.end()) {
+        targetFunctions.push_back(f);
+        targetNames.push_back(f->getName().str());
+    }
+
+    if (reachabilityMap.find(f) != reachabilityMap.end()) {
+        /* already computed */
+        return;
+    }
+
+    updateReachabilityMap(f, aa != NULL);
+}
+
+void ReachabilityAnalysis::removeTarget(Function *f) {
+    resolveFunctions();
+
+    vector<Function *>::iterator i = find(targetFunctions.begin(), targetFunctions.end(), f);
+    if (i == targetFunctions.end()) {
+        return;
+    }
+
+    targetNames.erase(targetNames.begin() + (i - targetFunctions.begin()));
+    targetFunctions.erase(i);
+    if (f != entryFunction) {
+        reachabilityMap.erase(f);
+    }
+}
+
 void ReachabilityAnalysis::updateReachabilityMap(Function *f, bool usePA) {
     FunctionSet &functions = reachabilityMap[f];
     computeReachableFunctions(f, usePA, functions);
@@ -133,6 +198,17 @@ void ReachabilityAnalysis::computeReachableFunctions(
     bool usePA,
     FunctionSet &results
 ) {
+    computeReachableFunctions(entry, usePA, usePA, results);
+}
+
+void ReachabilityAnalysis::computeReachableFunctions(
+    Function *entry,
+    bool usePA,
+    bool updateMaps,
+    FunctionSet &results
+) {
+    assert(!isReleased);
+
     stack<Function *> stack;
     FunctionSet pushed;
 
@@ -170,7 +246,7 @@ void ReachabilityAnalysis::computeReachableFunctions(
                 }
             }
 
-            if (usePA) {
+            if (updateMaps) {
                 updateCallMap(callInst, targets);
                 updateRetMap(callInst, targets);
             }
@@ -336,6 +412,8 @@ void ReachabilityAnalysis::getReachableInstructions(
     vector<CallInst *> &callSites,
     InstructionSet &result
 ) {
+    assert(!isReleased);
+
     stack<Instruction *> stack;
     InstructionSet visited;
 
@@ -398,6 +476,8 @@ void ReachabilityAnalysis::getReachableInstructions(
 }
 
 void ReachabilityAnalysis::getCallTargets(llvm::Instruction *inst, FunctionSet &result) {
+    assert(!isReleased);
+
     if (inst->getOpcode() != Instruction::Call) {
         return;
     }
@@ -410,6 +490,14 @@ void ReachabilityAnalysis::getCallTargets(llvm::Instruction *inst, FunctionSet &
     result = i->second;
 }
 
+void ReachabilityAnalysis::releaseTemporaries() {
+    /* only the reachable functions are kept */
+    functionTypeMap.clear();
+    callMap.clear();
+    retMap.clear();
+    isReleased = true;
+}
+
 void ReachabilityAnalysis::dumpReachableFunctions() {
     /* get all reachable functions */
     FunctionSet &reachable = getReachableFunctions(entryFunction);
@@ -421,3 +509,77 @@ void ReachabilityAnalysis::dumpReachableFunctions() {
     }
     debugs << "\n";
 }
+
+void ReachabilityAnalysis::computeDemandedValues(set<const Value *> &result) {
+    assert(!isReleased);
+
+    /* this may be called before run() */
+    resolveFunctions();
+
+    /* the maps are built again by run(), using the pointer analysis */
+    assert(callMap.empty() && retMap.empty());
+
+    /* the indirect calls are resolved by type (the call and return maps are built by type too) */
+    FunctionSet reachable;
+    if (entryFunction) {
+        computeReachableFunctions(entryFunction, false, true, reachable);
+    }
+
+    /* the targets may modify memory in any function which is reachable from them */
+    FunctionSet functions;
+    for (vector<Function *>::iterator i = targetFunctions.begin(); i != targetFunctions.end(); i++) {
+        Function *f = *i;
+        if (f) {
+            computeReachableFunctions(f, false, true, functions);
+        }
+    }
+
+    InstructionSet insts;
+    for (FunctionSet::iterator i = functions.begin(); i != functions.end(); i++) {
+        Function *f = *i;
+        if (f->isDeclaration()) {
+            continue;
+        }
+
+        for (inst_iterator j = inst_begin(f); j != inst_end(f); j++) {
+            insts.insert(&*j);
+        }
+    }
+
+    /* and the modifications are observed by the instructions which follow their call sites */
+    vector<CallInst *> callSites;
+    for (CallMap::iterator i = callMap.begin(); i != callMap.end(); i++) {
+        FunctionSet &targets = i->second;
+        for (vector<Function *>::iterator j = targetFunctions.begin(); j != targetFunctions.end(); j++) {
+            if (targets.find(*j) != targets.end()) {
+                callSites.push_back(dyn_cast<CallInst>(i->first));
+                break;
+            }
+        }
+    }
+    getReachableInstructions(callSites, insts);
+
+    /* the type based maps are coarser than the ones which are built by run() */
+    callMap.clear();
+    retMap.clear();
+
+    for (InstructionSet::iterator i = insts.begin(); i != insts.end(); i++) {
+        Instruction *inst = *i;
+
+        if (isa<LoadInst>(inst)) {
+            result.insert(dyn_cast<LoadInst>(inst)->getPointerOperand());
+        } else if (isa<StoreInst>(inst)) {
+            result.insert(dyn_cast<StoreInst>(inst)->getPointerOperand());
+        } else if (isa<CallInst>(inst)) {
+            CallInst *callInst = dyn_cast<CallInst>(inst);
+            if (!callInst->getCalledFunction()) {
+                result.insert(callInst->getCalledValue());
+            }
+
+            vector<Value *> pointers;
+            LibrarySummaries::getModifiedPointers(inst, pointers);
+            LibrarySummaries::getReadPointers(inst, pointers);
+            result.insert(pointers.begin(), pointers.end());
+        }
+    }
+}
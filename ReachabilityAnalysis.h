@@ -23,6 +23,26 @@ public:
     typedef std::map<llvm::Instruction *, FunctionSet> CallMap;
     typedef std::map<llvm::Function *, InstructionSet> RetMap;
 
+    ReachabilityAnalysis(
+        llvm::Module *module,
+        llvm::Function *entry,
+        std::vector<llvm::Function *> targets,
+        llvm::raw_ostream &debugs
+    ) :
+        module(module),
+        entryName(entry ? entry->getName().str() : ""),
+        targetNames(getNames(targets)),
+        isResolved(true),
+        entryFunction(entry),
+        targetFunctions(targets),
+        aa(NULL),
+        isReleased(false),
+        debugs(debugs)
+    {
+
+    }
+
+    /* the names are resolved by run() */
     ReachabilityAnalysis(
         llvm::Module *module,
         std::string entry,
@@ -30,14 +50,23 @@ public:
         llvm::raw_ostream &debugs
     ) :
         module(module),
-        entry(entry),
-        targets(targets),
+        entryName(entry),
+        targetNames(targets),
+        isResolved(false),
+        entryFunction(NULL),
         aa(NULL),
+        isReleased(false),
         debugs(debugs)
     {
 
     }
 
+    /* resolves the names (missing functions are mapped to NULL) */
+    static std::vector<llvm::Function *> getFunctions(llvm::Module *module, const std::vector<std::string> &names);
+
+    /* the names of the functions (NULL is mapped to an empty name) */
+    static std::vector<std::string> getNames(const std::vector<llvm::Function *> &functions);
+
     ~ReachabilityAnalysis() {};
 
     /* must be called before making any reachability analysis */
@@ -49,6 +78,12 @@ public:
 
     bool run(bool usePA);
 
+    /* compute the reachable functions of a target which was added after run() */
+    void addTarget(llvm::Function *f);
+
+    /* drop the reachable functions of a removed target (they are recomputed if it's added again) */
+    void removeTarget(llvm::Function *f);
+
     void computeReachableFunctions(
         llvm::Function *entry,
         bool usePA,
@@ -64,16 +99,33 @@ public:
 
     void getCallTargets(llvm::Instruction *inst, FunctionSet &result);
 
+    /* the pointers which may be queried by the analyses (before the pointer analysis is run) */
+    void computeDemandedValues(std::set<const llvm::Value *> &result);
+
+    /* free the state which is needed only for computing the reachable functions
+       (only getReachableFunctions may be used afterwards) */
+    void releaseTemporaries();
+
     void dumpReachableFunctions();
 
 private:
 
+    void resolveFunctions();
+
     void removeUnusedValues();
 
     bool removeUnusedValues(bool &changed);
 
     void computeFunctionTypeMap();
 
+    /* the call and return maps are updated only if updateMaps is set */
+    void computeReachableFunctions(
+        llvm::Function *entry,
+        bool usePA,
+        bool updateMaps,
+        FunctionSet &results
+    );
+
     void updateReachabilityMap(llvm::Function *f, bool usePA);
 
     bool isVirtual(llvm::Function *f);
@@ -95,8 +147,10 @@ private:
     llvm::Function *extractFunction(llvm::ConstantExpr *ce);
 
     llvm::Module *module;
-    std::string entry;
-    std::vector<std::string> targets;
+    /* used for diagnostics, and for resolving the functions if they were passed by name */
+    std::string entryName;
+    std::vector<std::string> targetNames;
+    bool isResolved;
     llvm::Function *entryFunction;
     std::vector<llvm::Function *> targetFunctions;
     AAPass *aa;
@@ -104,6 +158,8 @@ private:
     ReachabilityMap reachabilityMap;
     CallMap callMap;
     RetMap retMap;
+    /* the call and the type maps were freed */
+    bool isReleased;
     llvm::raw_ostream &debugs;
 };
 
@@ -1,6 +1,8 @@
 #include <stdio.h>
 
 #include <iostream>
+#include <algorithm>
+#include <thread>
 
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
@@ -24,12 +26,86 @@ void SVFPointerAnalysis::run() {
     /* update virtual call related nodes */
     handleVirtualCalls();
 
+    /* the subgraphs of the called functions are built by now */
+    computeAllocNodes();
+
+    if (threads > 1) {
+        translateParallel();
+        return;
+    }
+
     for (auto &v : pta->getNodesMap()) {
         PSNode *node = v.second.second;
         handleNode(node);
     }
 }
 
+void SVFPointerAnalysis::setThreads(unsigned int threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    this->threads = std::max(threads, 1U);
+}
+
+/*
+ * The operands are collected serially, and their points-to sets are fetched
+ * serially too (getPts may insert into the maps of SVF). Then, each thread
+ * translates a range of operands, and writes only to their points-to sets.
+ */
+void SVFPointerAnalysis::translateParallel() {
+    collecting = true;
+    for (auto &v : pta->getNodesMap()) {
+        PSNode *node = v.second.second;
+        handleNode(node);
+    }
+    collecting = false;
+
+    PAG *pag = aa->getPTA()->getPAG();
+    std::vector<PSNode *> operands;
+    std::vector<NodeID> ids;
+    for (PSNode *operand : pending) {
+        Value *value = operand->getUserData<Value>();
+        if (!value || !pag->hasValueNode(value)) {
+            continue;
+        }
+
+        NodeID id = pag->getValueNode(value);
+        aa->getPTA()->getPts(id);
+        operands.push_back(operand);
+        ids.push_back(id);
+    }
+    pending.clear();
+
+    /* the references are stable once all the entries exist */
+    std::vector<PointsTo *> ptsList;
+    for (NodeID id : ids) {
+        ptsList.push_back(&aa->getPTA()->getPts(id));
+    }
+
+    std::vector<std::thread> workers;
+    size_t chunk = (operands.size() + threads - 1) / threads;
+    for (size_t begin = 0; begin < operands.size(); begin += chunk) {
+        size_t end = std::min(begin + chunk, operands.size());
+        workers.push_back(std::thread(&SVFPointerAnalysis::translateRange, this, std::ref(operands), std::ref(ptsList), begin, end));
+    }
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void SVFPointerAnalysis::translateRange(
+    std::vector<PSNode *> &operands,
+    std::vector<PointsTo *> &ptsList,
+    size_t begin,
+    size_t end
+) {
+    for (size_t i = begin; i < end; i++) {
+        translatePointsTo(operands[i], *ptsList[i]);
+    }
+}
+
 void SVFPointerAnalysis::handleNode(PSNode *node) {
     Value *node_value = node->getUserData<Value>();
     //errs() << "NODE VALUE: "; node_value->print(errs()); errs() << "\n";
@@ -83,29 +159,41 @@ void SVFPointerAnalysis::handleNode(PSNode *node) {
 }
 
 void SVFPointerAnalysis::handleVirtualCalls() {
-    std::set<PSNode *> visited;
-    bool changed = true;
-
-    while (changed) {
-        std::set<PSNode *> discovered;
-        changed = false;
-
-        /* first, get all relevant nodes */
-        for (auto &v : pta->getNodesMap()) {
-            PSNode *node = v.second.second;
-            if (node->getType() != CALL_FUNCPTR) {
-                continue;
-            }
+    /* the calls of the initial graph, the others are found in the created subgraphs */
+    for (auto &v : pta->getNodesMap()) {
+        PSNode *node = v.second.second;
+        discovered.insert(node);
+        if (node->getType() == CALL_FUNCPTR) {
+            funcPtrWorklist.push_back(node);
+        }
+    }
 
-            if (visited.find(node) == visited.end()) {
-                discovered.insert(node);
-                changed = true;
-            }
+    while (!funcPtrWorklist.empty()) {
+        PSNode *node = funcPtrWorklist.back();
+        funcPtrWorklist.pop_back();
+        handleFuncPtr(node);
+    }
+}
+
+/* search a new subgraph for function pointer calls (each node is searched once) */
+void SVFPointerAnalysis::discoverFuncPtrCalls(PSNode *entry) {
+    std::vector<PSNode *> stack;
+    if (discovered.insert(entry).second) {
+        stack.push_back(entry);
+    }
+
+    while (!stack.empty()) {
+        PSNode *node = stack.back();
+        stack.pop_back();
+
+        if (node->getType() == CALL_FUNCPTR) {
+            funcPtrWorklist.push_back(node);
         }
 
-        for (PSNode *node : discovered) {
-            handleFuncPtr(node);
-            visited.insert(node);
+        for (PSNode *succ : node->getSuccessors()) {
+            if (discovered.insert(succ).second) {
+                stack.push_back(succ);
+            }
         }
     }
 }
@@ -181,10 +269,23 @@ bool SVFPointerAnalysis::functionPointerCall(PSNode *callsite, PSNode *called) {
 
     seq.second->addSuccessor(paired);
 
+    /* the subgraph may contain function pointer calls too */
+    discoverFuncPtrCalls(seq.first);
+
     return true;
 }
 
 void SVFPointerAnalysis::handleOperand(PSNode *operand) {
+    /* shared operands are translated once */
+    if (!translated.insert(operand).second) {
+        return;
+    }
+
+    if (collecting) {
+        pending.push_back(operand);
+        return;
+    }
+
     Value *value = operand->getUserData<Value>();
     if (!value) {
         return;
@@ -196,8 +297,10 @@ void SVFPointerAnalysis::handleOperand(PSNode *operand) {
     }
 
     NodeID id = aa->getPTA()->getPAG()->getValueNode(value);
-    PointsTo &pts = aa->getPTA()->getPts(id);
+    translatePointsTo(operand, aa->getPTA()->getPts(id));
+}
 
+void SVFPointerAnalysis::translatePointsTo(PSNode *operand, PointsTo &pts) {
     if (pts.empty()) {
         operand->addPointsTo(NULLPTR);
         return;
@@ -251,17 +354,49 @@ void SVFPointerAnalysis::updatePointsTo(PSNode *operand, PAGNode *pagnode) {
     operand->addPointsTo(Pointer(alloc_node, offset));
 }
 
+void SVFPointerAnalysis::computeAllocNodes() {
+    PAG *pag = aa->getPTA()->getPAG();
+
+    for (PAG::iterator i = pag->begin(); i != pag->end(); ++i) {
+        ObjPN *obj_node = dyn_cast<ObjPN>(i->second);
+        if (!obj_node) {
+            continue;
+        }
+
+        const MemObj *mo = obj_node->getMemObj();
+        if (allocNodes.find(mo) != allocNodes.end()) {
+            continue;
+        }
+
+        PSNode *ref_node = NULL;
+        if (mo->getRefVal()) {
+            ref_node = pta->builder->getNode(mo->getRefVal());
+        }
+
+        allocNodes[mo] = ref_node;
+    }
+
+    allocNodesComputed = true;
+}
+
 PSNode *SVFPointerAnalysis::getAllocNode(ObjPN *node) {
     /* get SVF memory object (allocation site) */
     const MemObj *mo = node->getMemObj();    
 
-    /* get corresponding DG node */
+    std::map<const MemObj *, PSNode *>::iterator entry = allocNodes.find(mo);
+    if (entry != allocNodes.end() && (entry->second || allocNodesComputed)) {
+        return entry->second;
+    }
+
+    /* get corresponding DG node (before computeAllocNodes, or if not found by it) */
     PSNode *ref_node = pta->builder->getNode(mo->getRefVal());
     if (!ref_node) {
         /* TODO: check why DG does not have this allocation site */
         //assert(false);
+        return NULL;
     }
 
+    allocNodes[mo] = ref_node;
     return ref_node;
 }
 
@@ -1,6 +1,10 @@
 #ifndef SVFPOINTERANALYSIS_H
 #define SVFPOINTERANALYSIS_H
 
+#include <map>
+#include <set>
+#include <vector>
+
 #include <llvm/IR/Module.h>
 #include <llvm/IR/DataLayout.h>
 
@@ -18,11 +22,17 @@ public:
     SVFPointerAnalysis(llvm::Module *module, LLVMPointerAnalysis *pta, AAPass *aa) : 
         module(module),
         pta(pta),
-        aa(aa) 
+        aa(aa),
+        allocNodesComputed(false),
+        threads(1),
+        collecting(false)
     {
 
     }
 
+    /* translate the points-to sets in parallel (0 threads means one thread per core) */
+    void setThreads(unsigned int threads);
+
     ~SVFPointerAnalysis() {
         //std::vector<PSNode *> nodes = ps->getNodes();
         //for (PSNode *n : nodes) {
@@ -40,15 +50,34 @@ public:
     void handleCast(PSNode *node);
     void handleFuncPtr(PSNode *node);
     bool functionPointerCall(PSNode *callsite, PSNode *called);
+    void discoverFuncPtrCalls(PSNode *entry);
     void handlePhi(PSNode *node);
     void handleOperand(PSNode *operand);
+    void translateParallel();
+    void translateRange(std::vector<PSNode *> &operands, std::vector<PointsTo *> &ptsList, size_t begin, size_t end);
+    void translatePointsTo(PSNode *operand, PointsTo &pts);
     void updatePointsTo(PSNode *operand, PAGNode *pagnode);
+    void computeAllocNodes();
     PSNode *getAllocNode(ObjPN *node);
-    uint64_t getAllocNodeOffset(GepObjPN *node);
+    static uint64_t getAllocNodeOffset(GepObjPN *node);
 
     llvm::Module *module;
     LLVMPointerAnalysis *pta;
     AAPass *aa;
+    /* the DG node of each SVF memory object */
+    std::map<const MemObj *, PSNode *> allocNodes;
+    /* the missing allocation sites won't be added (read-only from now on) */
+    bool allocNodesComputed;
+    /* the nodes which already have their points-to sets */
+    std::set<PSNode *> translated;
+    /* the unresolved function pointer calls */
+    std::vector<PSNode *> funcPtrWorklist;
+    /* the nodes which were already searched for function pointer calls */
+    std::set<PSNode *> discovered;
+    unsigned int threads;
+    /* when set, handleOperand only collects the operands to translate */
+    bool collecting;
+    std::vector<PSNode *> pending;
 };
 
 #endif
@@ -0,0 +1,152 @@
+#include <stdbool.h>
+#include <map>
+#include <vector>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Argument.h>
+#include <llvm/IR/Value.h>
+
+#include <MemoryModel/PAG.h>
+#include <MemoryModel/PointerAnalysis.h>
+
+#include "analysis/PointsTo/PointerSubgraph.h"
+#include "analysis/Offset.h"
+
+#include "AAPass.h"
+#include "SVFPointerAnalysis.h"
+#include "SVFPointerSubgraph.h"
+
+using namespace std;
+using namespace llvm;
+using namespace dg::analysis::pta;
+
+SVFPointerSubgraph::~SVFPointerSubgraph() {
+    for (vector<PSNode *>::iterator i = nodes.begin(); i != nodes.end(); i++) {
+        delete *i;
+    }
+}
+
+void SVFPointerSubgraph::build() {
+    /* the nodes are not connected, so the root is only a placeholder */
+    root = new PSNode(NOOP);
+    nodes.push_back(root);
+    pta->PS->setRoot(root);
+
+    /* the objects first, so the pointers can refer to them */
+    buildObjectNodes();
+    buildPointerNodes();
+}
+
+void SVFPointerSubgraph::buildObjectNodes() {
+    PAG *pag = aa->getPTA()->getPAG();
+
+    for (PAG::iterator i = pag->begin(); i != pag->end(); ++i) {
+        ObjPN *obj = dyn_cast<ObjPN>(i->second);
+        if (!obj || isa<DummyObjPN>(obj)) {
+            continue;
+        }
+
+        /* field objects share the node of their base object */
+        getObjectNode(obj->getMemObj());
+    }
+}
+
+void SVFPointerSubgraph::buildPointerNodes() {
+    BVDataPTAImpl *svfpta = aa->getPTA();
+    PAG *pag = svfpta->getPAG();
+
+    for (PAG::iterator i = pag->begin(); i != pag->end(); ++i) {
+        PAGNode *pagnode = i->second;
+        if (!isa<ValPN>(pagnode) || !pagnode->hasValue()) {
+            continue;
+        }
+
+        const Value *value = pagnode->getValue();
+        if (!isRelevant(value)) {
+            continue;
+        }
+
+        if (pta->getPointsTo(value)) {
+            /* an allocation site (already points to itself) */
+            continue;
+        }
+
+        PSNode *node = new PSNode(PHI, nullptr);
+        addNode(value, node);
+
+        PointsTo &pts = svfpta->getPts(i->first);
+        if (pts.empty()) {
+            node->addPointsTo(NULLPTR);
+            continue;
+        }
+
+        for (PointsTo::iterator j = pts.begin(); j != pts.end(); ++j) {
+            PAGNode *target = pag->getPAGNode(*j);
+            if (!isa<ObjPN>(target) || isa<DummyObjPN>(target)) {
+                continue;
+            }
+
+            PSNode *objectNode = getObjectNode(cast<ObjPN>(target)->getMemObj());
+            if (!objectNode) {
+                continue;
+            }
+
+            uint64_t offset = 0;
+            if (GepObjPN *gepobj = dyn_cast<GepObjPN>(target)) {
+                offset = SVFPointerAnalysis::getAllocNodeOffset(gepobj);
+            }
+
+            node->addPointsTo(Pointer(objectNode, offset));
+        }
+    }
+}
+
+PSNode *SVFPointerSubgraph::getObjectNode(const MemObj *mo) {
+    map<const MemObj *, PSNode *>::iterator entry = objectNodes.find(mo);
+    if (entry != objectNodes.end()) {
+        return entry->second;
+    }
+
+    PSNode *node = NULL;
+    const Value *value = mo->getRefVal();
+    if (value) {
+        if (isa<Function>(value)) {
+            node = new PSNode(FUNCTION);
+        } else if (mo->isHeap()) {
+            node = new PSNode(DYN_ALLOC);
+        } else {
+            node = new PSNode(ALLOC);
+        }
+
+        addNode(value, node);
+    }
+
+    objectNodes[mo] = node;
+    return node;
+}
+
+void SVFPointerSubgraph::addNode(const Value *value, PSNode *node) {
+    node->setUserData(const_cast<Value *>(value));
+    pta->builder->addNode(value, node);
+    nodes.push_back(node);
+}
+
+bool SVFPointerSubgraph::isRelevant(const Value *value) {
+    if (!isRestricted) {
+        return true;
+    }
+
+    const Function *f = NULL;
+    if (const Instruction *inst = dyn_cast<Instruction>(value)) {
+        f = inst->getParent()->getParent();
+    } else if (const Argument *arg = dyn_cast<Argument>(value)) {
+        f = arg->getParent();
+    } else {
+        /* globals, constants, etc. */
+        return true;
+    }
+
+    return functions.find(const_cast<Function *>(f)) != functions.end();
+}
@@ -0,0 +1,77 @@
+#ifndef SVFPOINTERSUBGRAPH_H
+#define SVFPOINTERSUBGRAPH_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Value.h>
+
+#include "llvm/analysis/PointsTo/PointerSubgraph.h"
+#include "llvm/analysis/PointsTo/PointsTo.h"
+
+#include "AAPass.h"
+
+using namespace dg;
+
+/*
+ * Builds the points-to view used by DG directly from the PAG and the solution
+ * of SVF, instead of building the pointer subgraph of DG and translating the
+ * results node by node. Only the nodes which are queried by DG are created:
+ * a node for each memory object (registered at its allocation site), and a
+ * node for each pointer (with its points-to set).
+ */
+class SVFPointerSubgraph {
+public:
+
+    SVFPointerSubgraph(llvm::Module *module, LLVMPointerAnalysis *pta, AAPass *aa) :
+        module(module),
+        pta(pta),
+        aa(aa),
+        root(NULL),
+        isRestricted(false)
+    {
+
+    }
+
+    ~SVFPointerSubgraph();
+
+    /* create the pointer nodes only for the values of the given functions (and the globals) */
+    void setFunctions(const std::set<llvm::Function *> &functions) {
+        this->functions = functions;
+        isRestricted = true;
+    }
+
+    void build();
+
+    uint32_t getNodesNum() {
+        return nodes.size();
+    }
+
+private:
+
+    void buildObjectNodes();
+
+    void buildPointerNodes();
+
+    PSNode *getObjectNode(const MemObj *mo);
+
+    void addNode(const llvm::Value *value, PSNode *node);
+
+    bool isRelevant(const llvm::Value *value);
+
+    llvm::Module *module;
+    LLVMPointerAnalysis *pta;
+    AAPass *aa;
+    PSNode *root;
+    /* the allocation site nodes */
+    std::map<const MemObj *, PSNode *> objectNodes;
+    /* all the created nodes (owned by this object) */
+    std::vector<PSNode *> nodes;
+    bool isRestricted;
+    std::set<llvm::Function *> functions;
+};
+
+#endif /* SVFPOINTERSUBGRAPH_H */
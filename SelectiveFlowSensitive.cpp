@@ -0,0 +1,98 @@
+#include <stdbool.h>
+#include <vector>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Value.h>
+
+#include <MemoryModel/PAG.h>
+#include <MemoryModel/PointerAnalysis.h>
+#include <MSSA/SVFG.h>
+#include <WPA/Andersen.h>
+#include <WPA/FlowSensitive.h>
+
+#include "SelectiveFlowSensitive.h"
+
+using namespace std;
+using namespace llvm;
+
+void SelectiveFlowSensitive::initialize(Module &module) {
+    /* runs Andersen and builds the SVFG */
+    FlowSensitive::initialize(module);
+    computeRelevantNodes();
+}
+
+PointsTo &SelectiveFlowSensitive::getPts(NodeID id) {
+    if (isRefined(id)) {
+        return FlowSensitive::getPts(id);
+    }
+
+    return ander->getPts(id);
+}
+
+bool SelectiveFlowSensitive::isRefined(NodeID id) {
+    const PAGNode *node = getPAG()->getPAGNode(id);
+    if (!svfg->hasDef(node)) {
+        return false;
+    }
+
+    return relevantNodes.test(svfg->getDefSVFGNode(node)->getId());
+}
+
+void SelectiveFlowSensitive::processNode(NodeID nodeId) {
+    if (!relevantNodes.test(nodeId)) {
+        /* doesn't affect any of the queried pointers */
+        skippedNodes++;
+        return;
+    }
+
+    FlowSensitive::processNode(nodeId);
+}
+
+bool SelectiveFlowSensitive::updateCallGraph(const CallSiteToFunPtrMap &callsites) {
+    bool changed = FlowSensitive::updateCallGraph(callsites);
+    if (changed) {
+        /* new edges may connect other nodes to the relevant ones (all the nodes are solved again) */
+        relevantNodes.clear();
+        computeRelevantNodes();
+    }
+
+    return changed;
+}
+
+/* the backward slice of the definitions of the queried pointers */
+void SelectiveFlowSensitive::computeRelevantNodes() {
+    PAG *pag = getPAG();
+    vector<const SVFGNode *> worklist;
+
+    for (ValueSet::iterator i = queries.begin(); i != queries.end(); i++) {
+        if (!pag->hasValueNode(*i)) {
+            continue;
+        }
+
+        const PAGNode *pagNode = pag->getPAGNode(pag->getValueNode(*i));
+        if (!svfg->hasDef(pagNode)) {
+            continue;
+        }
+
+        const SVFGNode *node = svfg->getDefSVFGNode(pagNode);
+        if (!relevantNodes.test(node->getId())) {
+            relevantNodes.set(node->getId());
+            worklist.push_back(node);
+        }
+    }
+
+    while (!worklist.empty()) {
+        const SVFGNode *node = worklist.back();
+        worklist.pop_back();
+
+        for (SVFGNode::const_iterator i = node->InEdgeBegin(); i != node->InEdgeEnd(); ++i) {
+            const SVFGNode *src = (*i)->getSrcNode();
+            if (relevantNodes.test(src->getId())) {
+                continue;
+            }
+
+            relevantNodes.set(src->getId());
+            worklist.push_back(src);
+        }
+    }
+}
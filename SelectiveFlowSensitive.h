@@ -0,0 +1,65 @@
+#ifndef SELECTIVEFLOWSENSITIVE_H
+#define SELECTIVEFLOWSENSITIVE_H
+
+#include <stdbool.h>
+#include <set>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Value.h>
+
+#include <MemoryModel/PointerAnalysis.h>
+#include <WPA/FlowSensitive.h>
+
+/*
+ * The sparse flow-sensitive analysis, restricted to the SVFG nodes which may
+ * affect the given pointers (their backward slice in the SVFG). The points-to
+ * sets of the other pointers are taken from the (whole-program) Andersen
+ * analysis, which is used for building the SVFG anyway.
+ */
+class SelectiveFlowSensitive : public FlowSensitive {
+public:
+
+    typedef std::set<const llvm::Value *> ValueSet;
+
+    SelectiveFlowSensitive(const ValueSet &queries) :
+        FlowSensitive(),
+        queries(queries),
+        skippedNodes(0)
+    {
+
+    }
+
+    virtual ~SelectiveFlowSensitive() {};
+
+    virtual void initialize(llvm::Module &module);
+
+    virtual PointsTo &getPts(NodeID id);
+
+    /* is the points-to set of the pointer computed flow-sensitively */
+    bool isRefined(NodeID id);
+
+    uint32_t getRelevantCount() {
+        return relevantNodes.count();
+    }
+
+    uint64_t getSkippedNodes() {
+        return skippedNodes;
+    }
+
+protected:
+
+    virtual void processNode(NodeID nodeId);
+
+    virtual bool updateCallGraph(const CallSiteToFunPtrMap &callsites);
+
+private:
+
+    void computeRelevantNodes();
+
+    ValueSet queries;
+    /* the relevant SVFG nodes */
+    NodeBS relevantNodes;
+    uint64_t skippedNodes;
+};
+
+#endif /* SELECTIVEFLOWSENSITIVE_H */
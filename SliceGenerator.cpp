@@ -1,8 +1,13 @@
 #include <stdbool.h>
 #include <iostream>
+#include <algorithm>
 
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/Support/Process.h>
 
 #include "llvm/analysis/PointsTo/PointsTo.h"
 
@@ -11,6 +16,7 @@
 #include "Annotator.h"
 #include "Cloner.h"
 #include "SVFPointerAnalysis.h"
+#include "SVFPointerSubgraph.h"
 #include "Slicer.h"
 #include "SliceGenerator.h"
 
@@ -19,36 +25,86 @@ using namespace llvm;
 using namespace dg;
 
 void SliceGenerator::generate() {
+    if (lazyMode && stripMode) {
+        /* the slices are generated during the execution, so the criteria can't be inserted */
+        directCriteriaMode = true;
+    }
+
 	/* add annotations for slicing */
 	annotator = new Annotator(module, mra);
+	annotator->setInstrumentMode(!directCriteriaMode);
 	annotator->annotate();
 
     /* notes:
        - UNKNOWN_OFFSET: field sensitive (not sure if this flag changes anything...)
        - main: we need the nodes of the whole program
+       - in restrict mode, only the nodes of the functions which are reachable
+         from the targets (the slices are built from their clones), the
+         points-to sets are taken from SVF anyway
     */
-    llvmpta = new LLVMPointerAnalysis(module, UNKNOWN_OFFSET, "main");
-    llvmpta->PS->setRoot(llvmpta->builder->buildLLVMPointerSubgraph());
+    string rootName = "main";
+    if (restrictMode) {
+        root = createRoot();
+        rootName = root->getName().str();
 
-    /* translate the results of SVF to DG */
-    SVFPointerAnalysis svfpa(module, llvmpta, aa);
-    svfpa.run();
+        vector<Function *> targets = mra->getTargets();
+        restrictTargets.insert(targets.begin(), targets.end());
+    }
+
+    llvmpta = new LLVMPointerAnalysis(module, UNKNOWN_OFFSET, rootName.c_str());
+    if (directMode) {
+        /* function pointer calls are resolved by DG using the points-to sets */
+        svfps = new SVFPointerSubgraph(module, llvmpta, aa);
+        if (restrictMode) {
+            set<Function *> functions;
+            vector<Function *> targets = mra->getTargets();
+            for (vector<Function *>::iterator i = targets.begin(); i != targets.end(); i++) {
+                set<Function *> &reachable = ra->getReachableFunctions(*i);
+                functions.insert(reachable.begin(), reachable.end());
+            }
+            svfps->setFunctions(functions);
+        }
+        svfps->build();
+    } else {
+        llvmpta->PS->setRoot(llvmpta->builder->buildLLVMPointerSubgraph());
+
+        /* translate the results of SVF to DG */
+        SVFPointerAnalysis svfpa(module, llvmpta, aa);
+        svfpa.setThreads(ptaThreads);
+        svfpa.run();
+    }
 
     if (lazyMode) {
         return;
     }
 
+    if (releaseMode) {
+        /* the slicer uses only the translated points-to sets */
+        size_t usage = sys::Process::GetMallocUsage();
+        aa->releasePTA();
+        size_t released = usage - min(usage, sys::Process::GetMallocUsage());
+        debugs << "released pointer analysis: " << released / 1024 << " KB\n";
+    }
+
     /* generate all the slices... */
     ModRefAnalysis::SideEffects &sideEffects = mra->getSideEffects();
     for (ModRefAnalysis::SideEffects::iterator i = sideEffects.begin(); i != sideEffects.end(); i++) {
         generateSlice(i->getFunction(), i->id, i->type);
     }
+
+    if (stripMode) {
+        removeAnnotations();
+    }
 }
 
 void SliceGenerator::generateSlice(Function *f, uint32_t sliceId, ModRefAnalysis::SideEffectType type) {
     std::vector<std::string> criterions;
     std::set<std::string> fnames;
 
+    assert(!isStripped);
+    /* a target which was added later has no pointer nodes */
+    assert(!restrictMode || restrictTargets.find(f) != restrictTargets.end());
+
     /* set criterion functions */
     switch (type) {
     case ModRefAnalysis::ReturnValue:
@@ -56,6 +112,10 @@ void SliceGenerator::generateSlice(Function *f, uint32_t sliceId, ModRefAnalysis
         break;
 
     case ModRefAnalysis::Modifier:
+        if (directCriteriaMode) {
+            break;
+        }
+
         fnames = annotator->getAnnotatedNames(sliceId);
         for (std::set<std::string>::iterator i = fnames.begin(); i != fnames.end(); i++) {
             std::string fname = *i;
@@ -72,14 +132,48 @@ void SliceGenerator::generateSlice(Function *f, uint32_t sliceId, ModRefAnalysis
     cloner->clone(f, sliceId);
 
     /* generate slice */
-    string entryName = f->getName().data();
-    Slicer slicer(module, 0, entryName, criterions, llvmpta, cloner);
+    Slicer slicer(module, 0, f, criterions, llvmpta, cloner);
     slicer.setSliceId(sliceId);
+    if (directCriteriaMode && type == ModRefAnalysis::Modifier) {
+        slicer.setCriterionInstructions(annotator->getStores(sliceId));
+    }
     slicer.run();
 
     markAsSliced(f, sliceId);
 }
 
+/* the dependence graphs are built from the original functions, so the criteria are needed until now */
+void SliceGenerator::removeAnnotations() {
+    vector<Instruction *> &annotations = annotator->getAnnotations();
+    if (annotations.empty()) {
+        /* not instrumented */
+        return;
+    }
+
+    /* the clones of the annotations must not be translated to the erased ones */
+    set<Value *> values(annotations.begin(), annotations.end());
+    cloner->removeTranslations(values);
+
+    /* the pointer nodes of the annotations are not valid any more (and no more slices are generated) */
+    releasePointerNodes();
+
+    annotator->removeAnnotations();
+    isStripped = true;
+}
+
+/* the pointer nodes refer to the root (and its calls), so it's erased only with them */
+void SliceGenerator::releasePointerNodes() {
+    delete llvmpta;
+    llvmpta = NULL;
+    delete svfps;
+    svfps = NULL;
+
+    if (root) {
+        root->eraseFromParent();
+        root = NULL;
+    }
+}
+
 void SliceGenerator::markAsSliced(Function *sliceEntry, uint32_t sliceId) {
     set<Function *> &reachable = ra->getReachableFunctions(sliceEntry);
 
@@ -95,6 +189,29 @@ void SliceGenerator::markAsSliced(Function *sliceEntry, uint32_t sliceId) {
     }
 }
 
+/* a function which calls each target (with undefined arguments) */
+Function *SliceGenerator::createRoot() {
+    LLVMContext &ctx = module->getContext();
+    FunctionType *type = FunctionType::get(Type::getVoidTy(ctx), false);
+    Function *f = Function::Create(type, GlobalValue::InternalLinkage, "__slicing_root", module);
+    BasicBlock *bb = BasicBlock::Create(ctx, "entry", f);
+
+    /* targets which are added later are not reachable from the root */
+    vector<Function *> targets = mra->getTargets();
+    for (vector<Function *>::iterator i = targets.begin(); i != targets.end(); i++) {
+        Function *target = *i;
+        vector<Value *> args;
+        for (Function::arg_iterator j = target->arg_begin(); j != target->arg_end(); j++) {
+            args.push_back(UndefValue::get(j->getType()));
+        }
+
+        CallInst::Create(target, args, "", bb);
+    }
+
+    ReturnInst::Create(ctx, bb);
+    return f;
+}
+
 void SliceGenerator::dumpSlice(Function *f, uint32_t sliceId, bool recursively) {
     Cloner::SliceInfo *sliceInfo = cloner->getSliceInfo(f, sliceId);
     if (!sliceInfo) {
@@ -124,6 +241,6 @@ void SliceGenerator::dumpSlice(Function *f, uint32_t sliceId, bool recursively)
 }
 
 SliceGenerator::~SliceGenerator() {
-    delete llvmpta;
+    releasePointerNodes();
     delete annotator;
 }
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <iostream>
+#include <set>
 
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
@@ -14,6 +15,7 @@
 #include "ModRefAnalysis.h"
 #include "Annotator.h"
 #include "Cloner.h"
+#include "SVFPointerSubgraph.h"
 
 class SliceGenerator {
 public:
@@ -35,11 +37,52 @@ public:
         debugs(debugs),
         lazyMode(lazyMode),
         annotator(0),
-        llvmpta(0)
+        llvmpta(0),
+        directMode(false),
+        svfps(0),
+        releaseMode(false),
+        restrictMode(false),
+        root(0),
+        stripMode(false),
+        isStripped(false),
+        directCriteriaMode(false),
+        ptaThreads(1)
     {
 
     }
 
+    /* build the points-to view of DG directly from SVF (without the pointer subgraph of DG) */
+    void setDirectMode(bool enabled) {
+        directMode = enabled;
+    }
+
+    /* release the pointer analysis once its results are translated to DG (eager mode only) */
+    void setReleaseMode(bool enabled) {
+        releaseMode = enabled;
+    }
+
+    /* build and translate the pointer nodes only for the functions reachable from the targets
+       (the targets which are added after generate() can't be sliced) */
+    void setRestrictMode(bool enabled) {
+        restrictMode = enabled;
+    }
+
+    /* remove the slicing criteria from the original functions once all the slices are generated
+       (in lazy mode, the originals are never instrumented: the stores are used as direct criteria) */
+    void setStripMode(bool enabled) {
+        stripMode = enabled;
+    }
+
+    /* pass the modifying stores to the slicer as criteria, without instrumenting the module */
+    void setDirectCriteriaMode(bool enabled) {
+        directCriteriaMode = enabled;
+    }
+
+    /* translate the points-to sets of SVF to DG in parallel (0 threads means one per core) */
+    void setPTAThreads(unsigned int threads) {
+        ptaThreads = threads;
+    }
+
     ~SliceGenerator();
 
     void generate();
@@ -52,10 +95,17 @@ public:
 
     void dumpSlice(llvm::Function *f, uint32_t sliceId, bool recursively = false);
 
+    /* in lazy mode (without strip mode), called by the client after the last slice is generated */
+    void removeAnnotations();
+
 private:
 
     void markAsSliced(llvm::Function *sliceEntry, uint32_t sliceId);
 
+    void releasePointerNodes();
+
+    llvm::Function *createRoot();
+
     llvm::Module *module;
     ReachabilityAnalysis *ra;
     AAPass *aa;
@@ -65,6 +115,20 @@ private:
     bool lazyMode;
     Annotator *annotator;
     dg::LLVMPointerAnalysis *llvmpta;
+    bool directMode;
+    SVFPointerSubgraph *svfps;
+    bool releaseMode;
+    bool restrictMode;
+    /* the targets which have pointer nodes in restrict mode */
+    std::set<llvm::Function *> restrictTargets;
+    /* calls the targets, used as the entry of the pointer subgraph in restrict mode
+       (internal and never called, but it stays in the module while the pointer nodes exist) */
+    llvm::Function *root;
+    bool stripMode;
+    /* the criteria are required for slicing, so no more slices can be generated */
+    bool isStripped;
+    bool directCriteriaMode;
+    unsigned int ptaThreads;
 };
 
 #endif
@@ -312,6 +312,7 @@ static int save_module(llvm::Module *M,
 Slicer::Slicer(
     llvm::Module *mod,
     uint32_t o,
+    llvm::Function *entry,
     std::string entryFunction,
     std::vector<std::string> criterions,
     LLVMPointerAnalysis *llvmpta,
@@ -319,6 +320,7 @@ Slicer::Slicer(
 ) :
     M(mod), 
     opts(o),
+    entry(entry),
     entryFunction(entryFunction),
     criterions(criterions),
     PTA(llvmpta),
@@ -345,6 +347,11 @@ int Slicer::run()
         return 1;
     }
 
+    if (!entry) {
+        errs() << "ERROR: The entry function not found: " << entryFunction << "\n";
+        return 1;
+    }
+
     // remove unused from module, we don't need that
     //remove_unused_from_module_rec();
 
@@ -386,7 +393,7 @@ bool Slicer::buildDG()
     tm.stop();
     tm.report("INFO: Points-to analysis took");
 
-    dg.build(M, PTA, M->getFunction(entryFunction));
+    dg.build(M, PTA, entry);
 
     // verify if the graph is built correctly
     // FIXME - do it optionally (command line argument)
@@ -403,7 +410,8 @@ bool Slicer::mark()
     debug::TimeMeasure tm;
     std::set<LLVMNode *> callsites;
 
-    assert(!criterions.empty() && "Do not have the slicing criterion");
+    assert((!criterions.empty() || !criterionInstructions.empty())
+           && "Do not have the slicing criterion");
 
     for (std::string c : criterions) {
         if (c == "ret") {
@@ -414,13 +422,26 @@ bool Slicer::mark()
     // check for slicing criterion here, because
     // we might have built new subgraphs that contain
     // it during points-to analysis
-    bool ret = dg.getCallSites(criterions, &callsites);
+    bool ret = true;
+    bool foundInstructions = true;
+    if (!criterions.empty())
+        ret = dg.getCallSites(criterions, &callsites);
+    if (!criterionInstructions.empty()) {
+        foundInstructions = getCriterionNodes(&callsites);
+        ret = foundInstructions && ret;
+    }
     got_slicing_criterion = true;
     if (!ret) {
-        errs() << "Did not find slicing criterion:\n";
+        errs() << "Did not find slicing criterion (slice " << slice_id << "):\n";
         for (std::string c : criterions) {
           errs() << "\tmissing criterion: " << c << "\n";
         }
+        for (llvm::Instruction *inst : criterionInstructions) {
+          if (foundInstructions)
+            break;
+          errs() << "\tmissing criterion: " << *inst
+                 << " (in " << inst->getParent()->getParent()->getName() << ")\n";
+        }
         got_slicing_criterion = false;
     }
 
@@ -475,6 +496,26 @@ bool Slicer::mark()
     return true;
 }
 
+bool Slicer::getCriterionNodes(std::set<LLVMNode *> *nodes)
+{
+    const auto& cf = getConstructedFunctions();
+    bool found = false;
+
+    for (llvm::Instruction *inst : criterionInstructions) {
+        auto entry = cf.find(inst->getParent()->getParent());
+        if (entry == cf.end())
+            continue;
+
+        LLVMNode *node = entry->second->getNode(inst);
+        if (node) {
+            nodes->insert(node);
+            found = true;
+        }
+    }
+
+    return found;
+}
+
 void Slicer::computeEdges()
 {
     debug::TimeMeasure tm;
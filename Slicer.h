@@ -2,6 +2,7 @@
 #define SLICER_H
 
 #include <stdio.h>
+#include <set>
 
 #include <llvm/IR/Module.h>
 
@@ -23,22 +24,44 @@ private:
 protected:
     llvm::Module *M;
     uint32_t opts = 0;
+    llvm::Function *entry;
+    // the reaching definitions analysis takes the entry by name
     std::string entryFunction;
     std::vector<std::string> criterions;
+    std::set<llvm::Instruction *> criterionInstructions;
     LLVMPointerAnalysis *PTA;
     std::unique_ptr<LLVMReachingDefinitions> RD;
     LLVMDependenceGraph dg;
     LLVMSlicer slicer;
 
-public:
+    // the entry may be NULL (reported by run()), the name is kept for the error
     Slicer(
         llvm::Module *mod,
         uint32_t o,
+        llvm::Function *entry,
         std::string entryFunction,
         std::vector<std::string> criterions,
         LLVMPointerAnalysis *llvmpta,
         Cloner *cloner
     );
+
+public:
+    Slicer(
+        llvm::Module *mod,
+        uint32_t o,
+        llvm::Function *entry,
+        std::vector<std::string> criterions,
+        LLVMPointerAnalysis *llvmpta,
+        Cloner *cloner
+    ) : Slicer(mod, o, entry, entry ? entry->getName().str() : "", criterions, llvmpta, cloner) {}
+    Slicer(
+        llvm::Module *mod,
+        uint32_t o,
+        std::string entryFunction,
+        std::vector<std::string> criterions,
+        LLVMPointerAnalysis *llvmpta,
+        Cloner *cloner
+    ) : Slicer(mod, o, mod->getFunction(entryFunction), entryFunction, criterions, llvmpta, cloner) {}
     ~Slicer();
 
     int run();
@@ -54,6 +77,12 @@ public:
     void setSliceId(uint32_t id) {
         slice_id = id;
     }
+    // criteria given as instructions (of the original functions),
+    // their nodes are looked up directly instead of by name
+    void setCriterionInstructions(const std::set<llvm::Instruction *> &insts) {
+        criterionInstructions = insts;
+    }
+    bool getCriterionNodes(std::set<LLVMNode *> *nodes);
 };
 
 #endif /* SLICER_H */
@@ -0,0 +1,74 @@
+#include <stdbool.h>
+#include <set>
+
+#include <llvm/IR/Module.h>
+
+#include <MemoryModel/PAG.h>
+#include <MemoryModel/PointerAnalysis.h>
+
+#include "StagedAndersen.h"
+
+using namespace std;
+using namespace llvm;
+
+/* the Steensgaard pre-pass is run by DemandAndersen::initialize */
+void StagedAndersen::computeRelevantNodes() {
+    PAG *pag = getPAG();
+
+    for (ValueSet::iterator i = queries.begin(); i != queries.end(); i++) {
+        if (pag->hasValueNode(*i)) {
+            addRelevantClass(pag->getValueNode(*i));
+        }
+    }
+
+    /* the call graph is resolved by Andersen (during the analysis) */
+    const PAG::CallSiteToFunPtrMap &indirectCalls = pag->getIndirectCallsites();
+    for (PAG::CallSiteToFunPtrMap::const_iterator i = indirectCalls.begin(); i != indirectCalls.end(); ++i) {
+        addRelevantClass(i->second);
+    }
+
+    /* a pointer is relevant if it flows (through memory) into a relevant pointer */
+    PAGEdge::PAGEdgeSetTy &loads = pag->getEdgeSet(PAGEdge::Load);
+    PAGEdge::PAGEdgeSetTy &stores = pag->getEdgeSet(PAGEdge::Store);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (PAGEdge::PAGEdgeSetTy::iterator i = loads.begin(); i != loads.end(); ++i) {
+            /* dst = *src */
+            if (isRelevantPointer((*i)->getDstID())) {
+                changed |= addRelevantClass((*i)->getSrcID());
+            }
+        }
+
+        for (PAGEdge::PAGEdgeSetTy::iterator i = stores.begin(); i != stores.end(); ++i) {
+            /* *dst = src */
+            if (isRelevantPointer((*i)->getSrcID())) {
+                changed |= addRelevantClass((*i)->getDstID());
+            }
+        }
+    }
+
+    for (PAG::iterator i = pag->begin(); i != pag->end(); ++i) {
+        /* the contents of the objects are propagated through the object nodes */
+        if (isa<ObjPN>(i->second) || isRelevantPointer(i->first)) {
+            relevant.set(i->first);
+        }
+    }
+}
+
+bool StagedAndersen::isRelevantPointer(NodeID id) {
+    if (!steensgaard->hasPointee(id)) {
+        return false;
+    }
+
+    return relevantClasses.find(steensgaard->getPointeeClass(id)) != relevantClasses.end();
+}
+
+bool StagedAndersen::addRelevantClass(NodeID id) {
+    if (!steensgaard->hasPointee(id)) {
+        return false;
+    }
+
+    return relevantClasses.insert(steensgaard->getPointeeClass(id)).second;
+}
@@ -0,0 +1,47 @@
+#ifndef STAGEDANDERSEN_H
+#define STAGEDANDERSEN_H
+
+#include <stdbool.h>
+#include <set>
+
+#include <llvm/IR/Module.h>
+
+#include <MemoryModel/PointerAnalysis.h>
+
+#include "DemandAndersen.h"
+
+/*
+ * Andersen, preceded by a Steensgaard pass. The Steensgaard classes which may
+ * affect the queried values are solved by Andersen, and the other nodes get
+ * the (coarse) Steensgaard points-to sets.
+ */
+class StagedAndersen : public DemandAndersen {
+public:
+
+    StagedAndersen(const ValueSet &queries) :
+        DemandAndersen(queries)
+    {
+
+    }
+
+    virtual ~StagedAndersen() {};
+
+    uint32_t getRelevantClasses() {
+        return relevantClasses.size();
+    }
+
+protected:
+
+    virtual void computeRelevantNodes();
+
+private:
+
+    bool isRelevantPointer(NodeID id);
+
+    bool addRelevantClass(NodeID id);
+
+    /* the pointee classes of the relevant pointers */
+    std::set<NodeID> relevantClasses;
+};
+
+#endif /* STAGEDANDERSEN_H */
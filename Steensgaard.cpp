@@ -0,0 +1,217 @@
+#include <stdbool.h>
+#include <vector>
+#include <map>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/Support/CallSite.h>
+
+#include <MemoryModel/PAG.h>
+#include <MemoryModel/PointerAnalysis.h>
+
+#include "Steensgaard.h"
+
+using namespace std;
+using namespace llvm;
+
+const NodeID Steensgaard::NoPointee;
+
+void Steensgaard::run() {
+    /* a class for each PAG node */
+    for (PAG::iterator i = pag->begin(); i != pag->end(); ++i) {
+        getNodeClass(i->first);
+    }
+
+    for (PAG::iterator i = pag->begin(); i != pag->end(); ++i) {
+        PAGNode *node = i->second;
+        for (PAGNode::const_iterator j = node->OutEdgeBegin(); j != node->OutEdgeEnd(); ++j) {
+            handleEdge(*j);
+        }
+    }
+
+    handleIndirectCalls();
+
+    /* group the objects by their classes */
+    for (PAG::iterator i = pag->begin(); i != pag->end(); ++i) {
+        if (isa<ObjPN>(i->second)) {
+            classObjects[getClass(i->first)].set(i->first);
+        }
+    }
+
+    isSolved = true;
+}
+
+NodeID Steensgaard::getClass(NodeID id) {
+    return find(getNodeClass(id));
+}
+
+bool Steensgaard::hasPointee(NodeID id) {
+    return pointees[getClass(id)] != NoPointee;
+}
+
+NodeID Steensgaard::getPointeeClass(NodeID id) {
+    NodeID pointee = pointees[getClass(id)];
+    assert(pointee != NoPointee);
+    return find(pointee);
+}
+
+PointsTo &Steensgaard::getPts(NodeID id) {
+    if (!hasPointee(id)) {
+        return empty;
+    }
+
+    map<NodeID, PointsTo>::iterator entry = classObjects.find(getPointeeClass(id));
+    if (entry == classObjects.end()) {
+        return empty;
+    }
+
+    return entry->second;
+}
+
+NodeID Steensgaard::createClass() {
+    NodeID id = parents.size();
+    parents.push_back(id);
+    ranks.push_back(0);
+    pointees.push_back(NoPointee);
+    return id;
+}
+
+NodeID Steensgaard::getNodeClass(NodeID id) {
+    NodeClassMap::iterator entry = nodeClasses.find(id);
+    if (entry != nodeClasses.end()) {
+        return entry->second;
+    }
+
+    NodeID c;
+    PAGNode *node = pag->getPAGNode(id);
+    if (isa<GepObjPN>(node)) {
+        /* field insensitive */
+        c = getClass(pag->getBaseObjNode(id));
+        if (isSolved) {
+            /* added to the PAG after the grouping of the objects */
+            classObjects[find(c)].set(id);
+        }
+    } else {
+        c = createClass();
+    }
+
+    nodeClasses[id] = c;
+    return c;
+}
+
+NodeID Steensgaard::find(NodeID c) {
+    assert(c < parents.size());
+    while (parents[c] != c) {
+        /* path halving */
+        parents[c] = parents[parents[c]];
+        c = parents[c];
+    }
+
+    return c;
+}
+
+/* unify two classes, and then (recursively) their pointees */
+void Steensgaard::join(NodeID a, NodeID b) {
+    vector<pair<NodeID, NodeID> > pending;
+    pending.push_back(make_pair(a, b));
+
+    while (!pending.empty()) {
+        NodeID x = find(pending.back().first);
+        NodeID y = find(pending.back().second);
+        pending.pop_back();
+
+        if (x == y) {
+            continue;
+        }
+
+        if (ranks[x] < ranks[y]) {
+            swap(x, y);
+        }
+        if (ranks[x] == ranks[y]) {
+            ranks[x]++;
+        }
+        parents[y] = x;
+
+        NodeID px = pointees[x];
+        NodeID py = pointees[y];
+        if (px == NoPointee) {
+            pointees[x] = py;
+        } else if (py != NoPointee) {
+            pending.push_back(make_pair(px, py));
+        }
+    }
+}
+
+/* the argument is a class id */
+NodeID Steensgaard::getOrCreatePointee(NodeID c) {
+    NodeID rep = find(c);
+    if (pointees[rep] == NoPointee) {
+        NodeID pointee = createClass();
+        pointees[rep] = pointee;
+    }
+
+    return find(pointees[rep]);
+}
+
+void Steensgaard::handleEdge(PAGEdge *edge) {
+    NodeID src = edge->getSrcID();
+    NodeID dst = edge->getDstID();
+
+    switch (edge->getEdgeKind()) {
+    case PAGEdge::Addr:
+        /* dst = &src */
+        join(getOrCreatePointee(getClass(dst)), getClass(src));
+        break;
+
+    case PAGEdge::Load:
+        /* dst = *src */
+        join(getOrCreatePointee(getClass(dst)), getOrCreatePointee(getOrCreatePointee(getClass(src))));
+        break;
+
+    case PAGEdge::Store:
+        /* *dst = src */
+        join(getOrCreatePointee(getOrCreatePointee(getClass(dst))), getOrCreatePointee(getClass(src)));
+        break;
+
+    default:
+        /* copy, gep (field insensitive), call, return, etc. */
+        join(getOrCreatePointee(getClass(dst)), getOrCreatePointee(getClass(src)));
+        break;
+    }
+}
+
+void Steensgaard::handleIndirectCalls() {
+    vector<Function *> functions;
+    for (Module::iterator i = module->begin(); i != module->end(); i++) {
+        Function *f = &*i;
+        if (f->hasAddressTaken() && !f->isDeclaration()) {
+            functions.push_back(f);
+        }
+    }
+
+    const PAG::CallSiteToFunPtrMap &indirectCalls = pag->getIndirectCallsites();
+    for (PAG::CallSiteToFunPtrMap::const_iterator i = indirectCalls.begin(); i != indirectCalls.end(); ++i) {
+        CallSite cs = i->first;
+
+        for (vector<Function *>::iterator j = functions.begin(); j != functions.end(); j++) {
+            Function *f = *j;
+
+            /* actual parameters */
+            Function::arg_iterator formal = f->arg_begin();
+            for (CallSite::arg_iterator actual = cs.arg_begin(); actual != cs.arg_end() && formal != f->arg_end(); ++actual, ++formal) {
+                if (pag->hasValueNode(actual->get()) && pag->hasValueNode(&*formal)) {
+                    NodeID src = pag->getValueNode(actual->get());
+                    NodeID dst = pag->getValueNode(&*formal);
+                    join(getOrCreatePointee(getClass(dst)), getOrCreatePointee(getClass(src)));
+                }
+            }
+
+            /* return value */
+            if (pag->funHasRet(f) && pag->hasValueNode(cs.getInstruction())) {
+                NodeID src = pag->getReturnNode(f);
+                NodeID dst = pag->getValueNode(cs.getInstruction());
+                join(getOrCreatePointee(getClass(dst)), getOrCreatePointee(getClass(src)));
+            }
+        }
+    }
+}
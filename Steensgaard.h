@@ -0,0 +1,84 @@
+#ifndef STEENSGAARD_H
+#define STEENSGAARD_H
+
+#include <stdbool.h>
+#include <vector>
+#include <map>
+
+#include <llvm/IR/Module.h>
+
+#include <MemoryModel/PAG.h>
+#include <MemoryModel/PointerAnalysis.h>
+
+/*
+ * A unification based (Steensgaard) analysis over the PAG.
+ *
+ * Each node belongs to an equivalence class, and each class has at most
+ * one pointee class. The analysis is field insensitive, and the indirect
+ * calls may target any function whose address is taken.
+ *
+ * The class ids are not PAG node ids: a pointee class may have no node.
+ * The nodes which are added to the PAG later (the field objects created
+ * by Andersen) are mapped to the class of their base object.
+ */
+class Steensgaard {
+public:
+
+    Steensgaard(PAG *pag, llvm::Module *module) :
+        pag(pag),
+        module(module),
+        isSolved(false)
+    {
+
+    }
+
+    ~Steensgaard() {};
+
+    void run();
+
+    /* the representative class id of the node */
+    NodeID getClass(NodeID id);
+
+    bool hasPointee(NodeID id);
+
+    /* the class of the objects which the node may point to */
+    NodeID getPointeeClass(NodeID id);
+
+    /* the objects which the node may point to */
+    PointsTo &getPts(NodeID id);
+
+private:
+
+    static const NodeID NoPointee = (NodeID)(-1);
+
+    typedef std::map<NodeID, NodeID> NodeClassMap;
+
+    NodeID createClass();
+
+    /* the class of a node (created on demand) */
+    NodeID getNodeClass(NodeID id);
+
+    NodeID find(NodeID c);
+
+    void join(NodeID a, NodeID b);
+
+    NodeID getOrCreatePointee(NodeID id);
+
+    void handleEdge(PAGEdge *edge);
+
+    void handleIndirectCalls();
+
+    PAG *pag;
+    llvm::Module *module;
+    NodeClassMap nodeClasses;
+    /* indexed by the class ids */
+    std::vector<NodeID> parents;
+    std::vector<uint32_t> ranks;
+    std::vector<NodeID> pointees;
+    std::map<NodeID, PointsTo> classObjects;
+    /* the classes are not joined any more */
+    bool isSolved;
+    PointsTo empty;
+};
+
+#endif /* STEENSGAARD_H */
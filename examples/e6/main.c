@@ -0,0 +1,36 @@
+#include <stdio.h>
+
+#include <klee/klee.h>
+
+typedef struct {
+    int x;
+    int y;
+} object_t;
+
+object_t g;
+
+void set_x(object_t *o, int v) {
+    o->x = v;
+}
+
+void set_y(object_t *o, int v) {
+    o->y = v;
+    g.y = v;
+}
+
+int main(int argc, char *argv[], char *envp[]) {
+    object_t o;
+    int k;
+
+    klee_make_symbolic(&k, sizeof(k), "k");
+
+    set_x(&o, k);
+    set_y(&o, k + 1);
+    if (o.x > 0) {
+        printf("%d\n", o.y);
+    } else {
+        printf("%d\n", g.y);
+    }
+
+    return 0;
+}
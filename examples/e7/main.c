@@ -0,0 +1,31 @@
+#include <stdio.h>
+
+#include <klee/klee.h>
+
+typedef struct {
+    int x;
+    int y;
+} object_t;
+
+void set(object_t *o, int v) {
+    o->x = v;
+}
+
+int main(int argc, char *argv[], char *envp[]) {
+    object_t a;
+    object_t b;
+    int k;
+
+    klee_make_symbolic(&k, sizeof(k), "k");
+
+    /* each call site modifies a different object */
+    set(&a, k);
+    set(&b, k + 1);
+    if (a.x > 0) {
+        printf("%d\n", b.x);
+    } else {
+        printf("%d\n", a.x);
+    }
+
+    return 0;
+}
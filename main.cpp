@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <iostream>
 
 #include <llvm/IRReader/IRReader.h>
@@ -16,12 +17,14 @@
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Process.h>
 
 #include <WPA/Andersen.h>
 #include <MemoryModel/PointerAnalysis.h>
 
 #include "ReachabilityAnalysis.h"
 #include "Inliner.h"
+#include "HeapCloner.h"
 #include "AAPass.h"
 #include "ModRefAnalysis.h"
 #include "Cloner.h"
@@ -31,9 +34,13 @@
 using namespace std;
 using namespace llvm;
 
+static void reportMemoryUsage(raw_ostream &debugs, const char *phase) {
+    debugs << "memory usage (" << phase << "): " << sys::Process::GetMallocUsage() / 1024 << " KB\n";
+}
+
 int main(int argc, char *argv[]) {
     if (argc < 3) {
-        fprintf(stderr, "Usage: <bitcode-file> <sliced-function-1> <sliced-function-2> ... \n");
+        fprintf(stderr, "Usage: <bitcode-file> [-heap-cloning] [-release] [-demand-pa] [-staged-pa] [-refine-pa] [-mod-ref-stats] [-pta-threads <n>] [-parallel-pa <n>] [-pa-benchmark] <sliced-function-1> <sliced-function-2> ... \n");
         return 1;
     }
 
@@ -47,29 +54,99 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    string entry = "main";
-    vector<string> targets;
+    Function *entry = module->getFunction("main");
+    vector<Function *> targets;
+    /* cloning the allocation wrappers changes the call sites, so it's opt-in */
+    bool heapCloning = false;
+    /* free the analysis state as soon as it's not needed (no later queries are possible) */
+    bool release = false;
+    /* solve the pointer analysis only for the pointers which may be queried */
+    bool demandPA = false;
+    /* solve with Andersen only the Steensgaard classes which may be queried */
+    bool stagedPA = false;
+    /* refine flow-sensitively only the pointers which may be queried */
+    bool refinePA = false;
+    /* report the sources of the side effects (to the debug log) */
+    bool modRefStats = false;
+    /* the threads which translate the points-to sets to DG (0 means one per core) */
+    unsigned int ptaThreads = 1;
+    /* solve the pointer analysis with the parallel solver (0 threads means one per core) */
+    bool parallelPA = false;
+    unsigned int paThreads = 0;
+    /* compare the parallel solver with the serial one (reported to the debug log) */
+    bool paBenchmark = false;
     for (unsigned int i = 2; i < argc; i++) {
-        std::string slicedFunction = std::string(argv[i]);
-        if (!module->getFunction(slicedFunction)) {
+        if (string(argv[i]) == "-heap-cloning") {
+            heapCloning = true;
+            continue;
+        }
+        if (string(argv[i]) == "-release") {
+            release = true;
+            continue;
+        }
+        if (string(argv[i]) == "-demand-pa") {
+            demandPA = true;
+            continue;
+        }
+        if (string(argv[i]) == "-staged-pa") {
+            stagedPA = true;
+            continue;
+        }
+        if (string(argv[i]) == "-refine-pa") {
+            refinePA = true;
+            continue;
+        }
+        if (string(argv[i]) == "-mod-ref-stats") {
+            modRefStats = true;
+            continue;
+        }
+        if (string(argv[i]) == "-pta-threads" && i + 1 < argc) {
+            ptaThreads = atoi(argv[++i]);
+            continue;
+        }
+        if (string(argv[i]) == "-parallel-pa" && i + 1 < argc) {
+            parallelPA = true;
+            paThreads = atoi(argv[++i]);
+            continue;
+        }
+        if (string(argv[i]) == "-pa-benchmark") {
+            paBenchmark = true;
+            continue;
+        }
+
+        Function *slicedFunction = module->getFunction(argv[i]);
+        if (!slicedFunction) {
             fprintf(stderr, "Sliced function '%s' not found...\n", argv[i]);
             return 1;
         }
         targets.push_back(slicedFunction);
     }
 
-    vector<string> inlineTargets;
+    if (targets.empty()) {
+        fprintf(stderr, "No sliced functions...\n");
+        return 1;
+    }
+
+    vector<Function *> inlineTargets;
 
     std::string errInfo;
     raw_fd_ostream debugs("/tmp/log", errInfo, sys::fs::F_None);
 
     ReachabilityAnalysis *ra = new ReachabilityAnalysis(module, entry, targets, debugs);
     Inliner *inliner = new Inliner(module, ra, targets, inlineTargets, debugs);
+    HeapCloner *heapCloner = new HeapCloner(module, targets, debugs);
     AAPass *aa = new AAPass();
     aa->setPAType(PointerAnalysis::Andersen_WPA);
+    if (parallelPA) {
+        aa->setParallel(paThreads);
+    }
+    aa->setBenchmarkMode(paBenchmark, debugs);
     ModRefAnalysis *mra = new ModRefAnalysis(module, ra, aa, entry, targets, debugs);
+    mra->setStatisticsMode(modRefStats);
     Cloner *cloner = new Cloner(module, ra, debugs);
     SliceGenerator *sg = new SliceGenerator(module, ra, aa, mra, cloner, debugs);
+    sg->setReleaseMode(release);
+    sg->setPTAThreads(ptaThreads);
 
     /* prepare reachability analysis */
     ra->prepare();
@@ -77,6 +154,26 @@ int main(int argc, char *argv[]) {
     /* run inlining */
     inliner->run();
 
+    /* clone the allocation wrappers (per call site) */
+    if (heapCloning) {
+        heapCloner->run();
+    }
+
+    /* the module is not changed anymore before the pointer analysis */
+    if (demandPA || stagedPA || refinePA) {
+        set<const Value *> demanded;
+        ra->computeDemandedValues(demanded);
+        if (demandPA) {
+            aa->setDemandedValues(demanded);
+        }
+        if (stagedPA) {
+            aa->setStagedValues(demanded);
+        }
+        if (refinePA) {
+            aa->setRefinedValues(demanded);
+        }
+    }
+
     /* run pointer analysis */
     legacy::PassManager pm;
     pm.add(aa);
@@ -88,9 +185,26 @@ int main(int argc, char *argv[]) {
 
     /* run mod-ref analysis */
     mra->run();
+    reportMemoryUsage(debugs, "mod-ref analysis");
+
+    if (release) {
+        /* only the results are used from now on */
+        mra->releaseBuildState();
+        ra->releaseTemporaries();
+        reportMemoryUsage(debugs, "released mod-ref state");
+    }
 
     /* run slicing */
     sg->generate();
+    reportMemoryUsage(debugs, "slicing");
+
+    delete sg;
+    delete cloner;
+    delete mra;
+    /* the pass manager owns (and deletes) aa */
+    delete heapCloner;
+    delete inliner;
+    delete ra;
 
     return 0;
 }
@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <iostream>
+#include <set>
+#include <map>
+#include <vector>
+
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <MemoryModel/PointerAnalysis.h>
+
+#include "ReachabilityAnalysis.h"
+#include "AAPass.h"
+#include "ModRefAnalysis.h"
+#include "Annotator.h"
+
+using namespace std;
+using namespace llvm;
+
+/*
+ * the target is called from several sites, each with its own object (passed as the first argument):
+ * in call-site mode, each call site has its own side effects (and annotations), which modify only its object
+ */
+
+typedef map<Instruction *, set<const Value *> > CallSiteObjectsMap;
+typedef map<Instruction *, set<uint32_t> > CallSiteIdsMap;
+
+static void getCallSites(Function *f, vector<CallInst *> &result) {
+    for (Value::use_iterator i = f->use_begin(); i != f->use_end(); i++) {
+        CallInst *callInst = dyn_cast<CallInst>(*i);
+        if (callInst && callInst->getCalledFunction() == f) {
+            result.push_back(callInst);
+        }
+    }
+}
+
+static bool check(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "failed: %s\n", message);
+    }
+
+    return condition;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: <bitcode-file> <target>\n");
+        return 1;
+    }
+
+    SMDiagnostic err;
+    Module *module = ParseIRFile(argv[1], err, getGlobalContext());
+    if (!module) {
+        return 1;
+    }
+
+    Function *entry = module->getFunction("main");
+    Function *target = module->getFunction(argv[2]);
+    if (!target) {
+        fprintf(stderr, "Target function '%s' not found...\n", argv[2]);
+        return 1;
+    }
+
+    vector<Function *> targets;
+    targets.push_back(target);
+
+    raw_ostream &debugs = nulls();
+    ReachabilityAnalysis *ra = new ReachabilityAnalysis(module, entry, targets, debugs);
+    AAPass *aa = new AAPass();
+    aa->setPAType(PointerAnalysis::Andersen_WPA);
+    ModRefAnalysis *mra = new ModRefAnalysis(module, ra, aa, entry, targets, debugs);
+    mra->setCallSiteMode(true);
+
+    ra->prepare();
+
+    legacy::PassManager pm;
+    pm.add(aa);
+    pm.run(*module);
+
+    ra->usePA(aa);
+    ra->run(true);
+    mra->run();
+
+    vector<CallInst *> callSites;
+    getCallSites(target, callSites);
+
+    CallSiteObjectsMap objectsMap;
+    CallSiteIdsMap idsMap;
+    ModRefAnalysis::SideEffects &sideEffects = mra->getSideEffects();
+    for (ModRefAnalysis::SideEffects::iterator i = sideEffects.begin(); i != sideEffects.end(); i++) {
+        if (i->type != ModRefAnalysis::Modifier) {
+            continue;
+        }
+
+        objectsMap[i->callSite].insert(i->info.modInfo.second.first);
+        idsMap[i->callSite].insert(i->id);
+    }
+
+    Annotator *annotator = new Annotator(module, mra);
+    annotator->annotate();
+
+    bool ok = true;
+    ok &= check(callSites.size() > 1, "the target must have several call sites");
+
+    set<uint32_t> ids;
+    for (vector<CallInst *>::iterator i = callSites.begin(); i != callSites.end(); i++) {
+        CallInst *callSite = *i;
+        const Value *object = callSite->getArgOperand(0)->stripPointerCasts();
+
+        set<const Value *> &objects = objectsMap[callSite];
+        ok &= check(objects.find(object) != objects.end(), "the object of the call site is not modified");
+
+        for (vector<CallInst *>::iterator j = callSites.begin(); j != callSites.end(); j++) {
+            if (*j == callSite) {
+                continue;
+            }
+
+            const Value *other = (*j)->getArgOperand(0)->stripPointerCasts();
+            ok &= check(objects.find(other) == objects.end(), "the object of another call site is modified");
+        }
+
+        /* each call site has its own slices, with their own criteria */
+        set<uint32_t> &callSiteIds = idsMap[callSite];
+        for (set<uint32_t>::iterator j = callSiteIds.begin(); j != callSiteIds.end(); j++) {
+            ok &= check(ids.insert(*j).second, "a slice id is shared by call sites");
+            ok &= check(!annotator->getAnnotatedNames(*j).empty(), "the slice has no annotations");
+            ok &= check(!annotator->getStores(*j).empty(), "the slice has no stores");
+        }
+    }
+
+    annotator->removeAnnotations();
+
+    delete annotator;
+    delete mra;
+    /* the pass manager owns (and deletes) aa */
+    delete ra;
+
+    if (!ok) {
+        return 1;
+    }
+
+    printf("%s: OK\n", argv[1]);
+    return 0;
+}
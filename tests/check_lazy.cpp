@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <iostream>
+#include <set>
+#include <map>
+#include <vector>
+
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/InstIterator.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <MemoryModel/PointerAnalysis.h>
+
+#include "ReachabilityAnalysis.h"
+#include "AAPass.h"
+#include "ModRefAnalysis.h"
+
+using namespace std;
+using namespace llvm;
+
+/* the side effects, the slice criteria and the answers of the lazy mode must be the same as in the eager mode */
+
+typedef set<pair<pair<ModRefAnalysis::SideEffectType, uint32_t>, pair<Function *, ModRefAnalysis::ModInfo> > > Summary;
+/* the stores of each slice (the criteria) */
+typedef map<uint32_t, set<Instruction *> > CriteriaMap;
+
+static void getSummary(ModRefAnalysis *mra, Summary &result) {
+    ModRefAnalysis::SideEffects &sideEffects = mra->getSideEffects();
+    for (ModRefAnalysis::SideEffects::iterator i = sideEffects.begin(); i != sideEffects.end(); i++) {
+        ModRefAnalysis::ModInfo modInfo;
+        if (i->type == ModRefAnalysis::Modifier) {
+            modInfo = i->info.modInfo;
+        }
+        result.insert(make_pair(make_pair(i->type, i->id), make_pair(i->getFunction(), modInfo)));
+    }
+}
+
+static void getCriteria(ModRefAnalysis *mra, CriteriaMap &result) {
+    ModRefAnalysis::ModInfoToStoreMap &modInfoToStoreMap = mra->getModInfoToStoreMap();
+    ModRefAnalysis::ModInfoToIdMap &modInfoToIdMap = mra->getModInfoToIdMap();
+    for (ModRefAnalysis::ModInfoToIdMap::iterator i = modInfoToIdMap.begin(); i != modInfoToIdMap.end(); i++) {
+        ModRefAnalysis::ModInfoToStoreMap::iterator entry = modInfoToStoreMap.find(i->first);
+        if (entry != modInfoToStoreMap.end()) {
+            result[i->second].insert(entry->second->begin(), entry->second->end());
+        }
+    }
+}
+
+static bool check(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "failed: %s\n", message);
+    }
+
+    return condition;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: <bitcode-file> <target> ...\n");
+        return 1;
+    }
+
+    SMDiagnostic err;
+    Module *module = ParseIRFile(argv[1], err, getGlobalContext());
+    if (!module) {
+        return 1;
+    }
+
+    Function *entry = module->getFunction("main");
+    vector<Function *> targets;
+    for (unsigned int i = 2; i < argc; i++) {
+        Function *target = module->getFunction(argv[i]);
+        if (!target) {
+            fprintf(stderr, "Target function '%s' not found...\n", argv[i]);
+            return 1;
+        }
+        targets.push_back(target);
+    }
+
+    raw_ostream &debugs = nulls();
+    ReachabilityAnalysis *ra = new ReachabilityAnalysis(module, entry, targets, debugs);
+    AAPass *aa = new AAPass();
+    aa->setPAType(PointerAnalysis::Andersen_WPA);
+    ModRefAnalysis *eager = new ModRefAnalysis(module, ra, aa, entry, targets, debugs);
+    ModRefAnalysis *lazy = new ModRefAnalysis(module, ra, aa, entry, targets, debugs, true);
+
+    ra->prepare();
+
+    legacy::PassManager pm;
+    pm.add(aa);
+    pm.run(*module);
+
+    ra->usePA(aa);
+    ra->run(true);
+    eager->run();
+    lazy->run();
+
+    bool ok = true;
+
+    Summary eagerSummary, lazySummary;
+    getSummary(eager, eagerSummary);
+    getSummary(lazy, lazySummary);
+    ok &= check(!eagerSummary.empty(), "no side effects");
+    ok &= check(eagerSummary == lazySummary, "the side effects differ");
+
+    CriteriaMap eagerCriteria, lazyCriteria;
+    getCriteria(eager, eagerCriteria);
+    getCriteria(lazy, lazyCriteria);
+    ok &= check(eagerCriteria == lazyCriteria, "the slice criteria differ");
+
+    /* the lazy answers are computed on demand */
+    bool blocks = true, overrides = true;
+    for (Module::iterator f = module->begin(); f != module->end(); f++) {
+        if (f->isDeclaration()) {
+            continue;
+        }
+
+        for (inst_iterator i = inst_begin(&*f); i != inst_end(&*f); i++) {
+            Instruction *inst = &*i;
+            if (isa<LoadInst>(inst)) {
+                blocks &= eager->mayBlock(inst) == lazy->mayBlock(inst);
+            }
+            if (isa<StoreInst>(inst)) {
+                overrides &= eager->mayOverride(inst) == lazy->mayOverride(inst);
+            }
+        }
+    }
+    ok &= check(blocks, "the blocking loads differ");
+    ok &= check(overrides, "the overriding stores differ");
+    ok &= check(eager->getOverridingStores() == lazy->getOverridingStores(), "the overriding store sets differ");
+
+    delete lazy;
+    delete eager;
+    /* the pass manager owns (and deletes) aa */
+    delete ra;
+
+    if (!ok) {
+        return 1;
+    }
+
+    printf("%s: OK\n", argv[1]);
+    return 0;
+}
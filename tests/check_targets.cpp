@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <MemoryModel/PointerAnalysis.h>
+
+#include "ReachabilityAnalysis.h"
+#include "AAPass.h"
+#include "ModRefAnalysis.h"
+
+using namespace std;
+using namespace llvm;
+
+/* removes a target and adds it again, the results must be the same as before */
+
+typedef set<pair<ModRefAnalysis::SideEffectType, ModRefAnalysis::ModInfo> > Summary;
+
+static void getSummary(ModRefAnalysis *mra, Function *f, Summary &result) {
+    ModRefAnalysis::SideEffects &sideEffects = mra->getSideEffects();
+    for (ModRefAnalysis::SideEffects::iterator i = sideEffects.begin(); i != sideEffects.end(); i++) {
+        if (i->getFunction() != f) {
+            continue;
+        }
+
+        ModRefAnalysis::ModInfo modInfo;
+        if (i->type == ModRefAnalysis::Modifier) {
+            modInfo = i->info.modInfo;
+        }
+        result.insert(make_pair(i->type, modInfo));
+    }
+}
+
+static bool check(bool condition, const char *message) {
+    if (!condition) {
+        fprintf(stderr, "failed: %s\n", message);
+    }
+
+    return condition;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: <bitcode-file> <removed-target> <other-target> ...\n");
+        return 1;
+    }
+
+    SMDiagnostic err;
+    Module *module = ParseIRFile(argv[1], err, getGlobalContext());
+    if (!module) {
+        return 1;
+    }
+
+    Function *entry = module->getFunction("main");
+    vector<Function *> targets;
+    for (unsigned int i = 2; i < argc; i++) {
+        Function *target = module->getFunction(argv[i]);
+        if (!target) {
+            fprintf(stderr, "Target function '%s' not found...\n", argv[i]);
+            return 1;
+        }
+        targets.push_back(target);
+    }
+
+    raw_ostream &debugs = nulls();
+    ReachabilityAnalysis *ra = new ReachabilityAnalysis(module, entry, targets, debugs);
+    AAPass *aa = new AAPass();
+    aa->setPAType(PointerAnalysis::Andersen_WPA);
+    ModRefAnalysis *mra = new ModRefAnalysis(module, ra, aa, entry, targets, debugs);
+
+    ra->prepare();
+
+    legacy::PassManager pm;
+    pm.add(aa);
+    pm.run(*module);
+
+    ra->usePA(aa);
+    ra->run(true);
+    mra->run();
+
+    Function *f = targets[0];
+    Summary before, removed, after;
+    getSummary(mra, f, before);
+    ReachabilityAnalysis::FunctionSet reachable = ra->getReachableFunctions(f);
+
+    mra->removeTarget(f);
+    getSummary(mra, f, removed);
+
+    mra->addTarget(f);
+    getSummary(mra, f, after);
+
+    bool ok = true;
+    ok &= check(!before.empty(), "the target has no side effects");
+    ok &= check(removed.empty(), "the side effects of the removed target remain");
+    ok &= check(before == after, "the side effects differ after adding the target again");
+    ok &= check(reachable == ra->getReachableFunctions(f), "the reachable functions differ");
+
+    delete mra;
+    /* the pass manager owns (and deletes) aa */
+    delete ra;
+
+    if (!ok) {
+        return 1;
+    }
+
+    printf("%s: OK\n", argv[1]);
+    return 0;
+}
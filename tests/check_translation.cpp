@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <set>
+#include <map>
+
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <MemoryModel/PointerAnalysis.h>
+
+#include "llvm/analysis/PointsTo/PointsTo.h"
+
+#include "AAPass.h"
+#include "SVFPointerAnalysis.h"
+
+using namespace std;
+using namespace llvm;
+using namespace dg;
+using namespace dg::analysis::pta;
+
+/* translates the points-to sets serially and in parallel, the results must be the same */
+
+/* the targets are identified by their values (or by the node, e.g. the null pointer) */
+typedef set<pair<const void *, uint64_t> > PointsToSummary;
+typedef map<const Value *, PointsToSummary> Summary;
+
+static LLVMPointerAnalysis *translate(Module *module, AAPass *aa, unsigned int threads) {
+    LLVMPointerAnalysis *llvmpta = new LLVMPointerAnalysis(module, UNKNOWN_OFFSET, "main");
+    llvmpta->PS->setRoot(llvmpta->builder->buildLLVMPointerSubgraph());
+
+    SVFPointerAnalysis svfpa(module, llvmpta, aa);
+    svfpa.setThreads(threads);
+    svfpa.run();
+
+    return llvmpta;
+}
+
+static void getSummary(LLVMPointerAnalysis *llvmpta, Summary &result) {
+    for (auto &v : llvmpta->getNodesMap()) {
+        PSNode *node = v.second.second;
+        PointsToSummary &pts = result[v.first];
+        for (const Pointer &ptr : node->pointsTo) {
+            const Value *value = ptr.target->getUserData<Value>();
+            const void *target = value ? (const void *)(value) : (const void *)(ptr.target);
+            pts.insert(make_pair(target, ptr.offset.offset));
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: <bitcode-file> [<threads>]\n");
+        return 1;
+    }
+
+    SMDiagnostic err;
+    Module *module = ParseIRFile(argv[1], err, getGlobalContext());
+    if (!module) {
+        return 1;
+    }
+
+    unsigned int threads = 4;
+    if (argc > 2) {
+        threads = atoi(argv[2]);
+    }
+
+    AAPass *aa = new AAPass();
+    aa->setPAType(PointerAnalysis::Andersen_WPA);
+
+    legacy::PassManager pm;
+    pm.add(aa);
+    pm.run(*module);
+
+    LLVMPointerAnalysis *serial = translate(module, aa, 1);
+    LLVMPointerAnalysis *parallel = translate(module, aa, threads);
+
+    Summary serialSummary, parallelSummary;
+    getSummary(serial, serialSummary);
+    getSummary(parallel, parallelSummary);
+
+    bool ok = serialSummary == parallelSummary;
+    if (!ok) {
+        fprintf(stderr, "failed: the parallel translation differs from the serial one\n");
+    }
+
+    delete parallel;
+    delete serial;
+    /* the pass manager owns (and deletes) aa */
+
+    if (!ok) {
+        return 1;
+    }
+
+    printf("%s: OK\n", argv[1]);
+    return 0;
+}
@@ -0,0 +1,36 @@
+#!/bin/bash
+
+LIBS_PATH=~/tau/slicing/SVF/build/lib:~/tau/slicing/SVF/build/lib/CUDD:~/tau/slicing/dg/build/src
+
+LD_LIBRARY_PATH=${LIBS_PATH} ../check_targets ../examples/e6/final.bc set_y set_x || exit 1
+LD_LIBRARY_PATH=${LIBS_PATH} ../check_targets ../examples/e6/final.bc set_x set_y || exit 1
+echo "check_targets: OK"
+
+LD_LIBRARY_PATH=${LIBS_PATH} ../check_translation ../examples/e5/final.bc 4 || exit 1
+LD_LIBRARY_PATH=${LIBS_PATH} ../check_translation ../examples/e6/final.bc 4 || exit 1
+echo "check_translation: OK"
+
+LD_LIBRARY_PATH=${LIBS_PATH} ../check_lazy ../examples/e6/final.bc set_x set_y || exit 1
+LD_LIBRARY_PATH=${LIBS_PATH} ../check_lazy ../examples/e5/final.bc parser_parse_tokens || exit 1
+echo "check_lazy: OK"
+
+LD_LIBRARY_PATH=${LIBS_PATH} ../check_call_sites ../examples/e7/final.bc set || exit 1
+echo "check_call_sites: OK"
+
+# the released analyses must not change the slices (the sliced module is saved as test.sliced)
+function check_release {
+    file=$1
+    shift
+    rm -rf out out.release
+    mkdir out out.release
+    (cd out && LD_LIBRARY_PATH=${LIBS_PATH} ../../main ../${file} "$@" 1>/dev/null 2>/dev/null) || return 1
+    (cd out.release && LD_LIBRARY_PATH=${LIBS_PATH} ../../main ../${file} -release "$@" 1>/dev/null 2>/dev/null) || return 1
+    cmp -s out/test.sliced out.release/test.sliced
+    code=$?
+    rm -rf out out.release
+    return ${code}
+}
+
+check_release ../examples/e6/final.bc set_x set_y || { echo "failed: release (e6)"; exit 1; }
+check_release ../examples/e5/final.bc parser_parse_tokens || { echo "failed: release (e5)"; exit 1; }
+echo "check_release: OK"